@@ -0,0 +1,247 @@
+/**
+ *  @file   LArReco/benchmark/GapLookupBenchmark.cxx
+ *
+ *  @brief  Implementation of the gap lookup benchmark, comparing the detector gap index with iteration over every detector gap
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Geometry/DetectorGap.h"
+#include "Geometry/LArTPC.h"
+#include "Managers/GeometryManager.h"
+#include "Persistency/BinaryFileReader.h"
+#include "Persistency/XmlFileReader.h"
+
+#include "GapLookupBenchmark.h"
+#include "GeometryCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+
+#include <getopt.h>
+
+using namespace pandora;
+using namespace lar_reco;
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        GapLookupParameters parameters;
+
+        if (!ParseCommandLine(argc, argv, parameters))
+            return 1;
+
+        const Pandora pandora;
+        const bool isBinary((parameters.m_geometryFileName.size() >= 5) &&
+            (0 == parameters.m_geometryFileName.compare(parameters.m_geometryFileName.size() - 5, 5, ".pndr")));
+        std::unique_ptr<FileReader> pFileReader(isBinary ? static_cast<FileReader *>(new BinaryFileReader(pandora, parameters.m_geometryFileName))
+                                                         : static_cast<FileReader *>(new XmlFileReader(pandora, parameters.m_geometryFileName)));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, pFileReader->ReadGeometry());
+
+        if (pandora.GetGeometry()->GetLArTPCMap().empty())
+        {
+            std::cout << "LArRecoGapLookupBenchmark, no LArTPCs found in geometry file " << parameters.m_geometryFileName << std::endl;
+            return 1;
+        }
+
+        unsigned int nMismatches(0);
+
+        for (const HitType hitType : {TPC_VIEW_U, TPC_VIEW_V, TPC_VIEW_W, TPC_3D})
+            nMismatches += RunGapLookupBenchmark(parameters, pandora, hitType);
+
+        return ((0 == nMismatches) ? 0 : 1);
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << statusCodeException.GetBackTrace() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception: " << std::endl;
+    }
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+unsigned int RunGapLookupBenchmark(const GapLookupParameters &parameters, const Pandora &pandora, const HitType hitType)
+{
+    const DetectorGapList &detectorGapList(pandora.GetGeometry()->GetDetectorGapList());
+
+    // Positions are drawn from the lar tpcs, extended to cover the finite gaps of the view, as a wire coordinate in a view or in 3D
+    float minX(std::numeric_limits<float>::max()), maxX(-std::numeric_limits<float>::max());
+    float minY(std::numeric_limits<float>::max()), maxY(-std::numeric_limits<float>::max());
+    float minZ(std::numeric_limits<float>::max()), maxZ(-std::numeric_limits<float>::max());
+
+    for (const LArTPCMap::value_type &mapEntry : pandora.GetGeometry()->GetLArTPCMap())
+    {
+        const LArTPC *const pLArTPC(mapEntry.second);
+        minX = std::min(minX, pLArTPC->GetCenterX() - 0.5f * pLArTPC->GetWidthX());
+        maxX = std::max(maxX, pLArTPC->GetCenterX() + 0.5f * pLArTPC->GetWidthX());
+        minY = std::min(minY, pLArTPC->GetCenterY() - 0.5f * pLArTPC->GetWidthY());
+        maxY = std::max(maxY, pLArTPC->GetCenterY() + 0.5f * pLArTPC->GetWidthY());
+        minZ = std::min(minZ, pLArTPC->GetCenterZ() - 0.5f * pLArTPC->GetWidthZ());
+        maxZ = std::max(maxZ, pLArTPC->GetCenterZ() + 0.5f * pLArTPC->GetWidthZ());
+    }
+
+    unsigned int nGaps(0);
+
+    for (const DetectorGap *const pDetectorGap : detectorGapList)
+    {
+        const LineGap *const pLineGap(dynamic_cast<const LineGap *>(pDetectorGap));
+        const LineGapType lineGapType(pLineGap ? pLineGap->GetLineGapType() : TPC_DRIFT_GAP);
+
+        if (pLineGap && (((TPC_VIEW_U == hitType) && (TPC_WIRE_GAP_VIEW_U != lineGapType) && (TPC_DRIFT_GAP != lineGapType)) ||
+                            ((TPC_VIEW_V == hitType) && (TPC_WIRE_GAP_VIEW_V != lineGapType) && (TPC_DRIFT_GAP != lineGapType)) ||
+                            ((TPC_VIEW_W == hitType) && (TPC_WIRE_GAP_VIEW_W != lineGapType) && (TPC_DRIFT_GAP != lineGapType))))
+        {
+            continue;
+        }
+
+        ++nGaps;
+
+        if (pLineGap && (TPC_3D != hitType) && (TPC_DRIFT_GAP != lineGapType))
+        {
+            minZ = std::min(minZ, std::min(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ()));
+            maxZ = std::max(maxZ, std::max(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ()));
+        }
+    }
+
+    std::mt19937 randomEngine(parameters.m_seed);
+    std::uniform_real_distribution<float> xDistribution(minX, maxX), yDistribution(minY, maxY), zDistribution(minZ, maxZ);
+    std::vector<CartesianVector> positionVector;
+    positionVector.reserve(parameters.m_nPositions);
+
+    for (int iPosition = 0; iPosition < parameters.m_nPositions; ++iPosition)
+    {
+        const float x(xDistribution(randomEngine)), y(yDistribution(randomEngine)), z(zDistribution(randomEngine));
+        positionVector.emplace_back(x, (TPC_3D == hitType) ? y : 0.f, z);
+    }
+
+    std::vector<char> iterationResultVector, indexResultVector;
+    iterationResultVector.reserve(positionVector.size());
+    indexResultVector.reserve(positionVector.size());
+
+    const std::chrono::steady_clock::time_point iterationStartTime(std::chrono::steady_clock::now());
+
+    for (const CartesianVector &position : positionVector)
+    {
+        bool isInGap(false);
+
+        for (const DetectorGap *const pDetectorGap : detectorGapList)
+        {
+            if (pDetectorGap->IsInGap(position, hitType, parameters.m_gapTolerance))
+            {
+                isInGap = true;
+                break;
+            }
+        }
+
+        iterationResultVector.push_back(isInGap);
+    }
+
+    const std::chrono::steady_clock::time_point buildStartTime(std::chrono::steady_clock::now());
+    const DetectorGapIndex detectorGapIndex(detectorGapList, parameters.m_gapTolerance);
+    const std::chrono::steady_clock::time_point indexStartTime(std::chrono::steady_clock::now());
+
+    for (const CartesianVector &position : positionVector)
+        indexResultVector.push_back(detectorGapIndex.IsInGap(position, hitType));
+
+    const std::chrono::steady_clock::time_point endTime(std::chrono::steady_clock::now());
+
+    unsigned int nInGap(0), nMismatches(0);
+
+    for (unsigned int iPosition = 0; iPosition < positionVector.size(); ++iPosition)
+    {
+        nInGap += (iterationResultVector.at(iPosition) ? 1 : 0);
+        nMismatches += ((iterationResultVector.at(iPosition) != indexResultVector.at(iPosition)) ? 1 : 0);
+    }
+
+    const double nPositions(std::max<std::size_t>(positionVector.size(), 1));
+    const double iterationTime(std::chrono::duration<double, std::nano>(buildStartTime - iterationStartTime).count() / nPositions);
+    const double indexTime(std::chrono::duration<double, std::nano>(endTime - indexStartTime).count() / nPositions);
+    const double buildTime(std::chrono::duration<double, std::micro>(indexStartTime - buildStartTime).count());
+
+    std::cout << "LArRecoGapLookupBenchmark, " << ((TPC_VIEW_U == hitType) ? "U " : (TPC_VIEW_V == hitType) ? "V " : (TPC_VIEW_W == hitType) ? "W " : "3D")
+              << ": " << std::setw(4) << nGaps << " gaps, " << std::fixed << std::setprecision(1) << std::setw(5) << (100. * nInGap / nPositions)
+              << "% in gaps, iteration " << std::setw(7) << iterationTime << " ns, index " << std::setw(6) << indexTime << " ns per lookup ("
+              << std::setprecision(1) << (iterationTime / std::max(indexTime, 1.e-3)) << "x), index built in " << buildTime << " us, "
+              << nMismatches << " mismatches" << std::defaultfloat << std::endl;
+
+    return nMismatches;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ParseCommandLine(int argc, char *argv[], GapLookupParameters &parameters)
+{
+    if (1 == argc)
+        return PrintOptions();
+
+    int c(0);
+
+    while ((c = getopt(argc, argv, "g:n:t:r:h")) != -1)
+    {
+        switch (c)
+        {
+            case 'g':
+                parameters.m_geometryFileName = optarg;
+                break;
+            case 'n':
+                parameters.m_nPositions = std::atoi(optarg);
+                break;
+            case 't':
+                parameters.m_gapTolerance = std::atof(optarg);
+                break;
+            case 'r':
+                parameters.m_seed = std::strtoul(optarg, nullptr, 10);
+                break;
+            case 'h':
+            default:
+                return PrintOptions();
+        }
+    }
+
+    if (parameters.m_geometryFileName.empty())
+    {
+        std::cout << "LArRecoGapLookupBenchmark, the geometry file is required" << std::endl;
+        return PrintOptions();
+    }
+
+    if (parameters.m_nPositions < 1)
+    {
+        std::cout << "LArRecoGapLookupBenchmark, the number of positions must be at least one" << std::endl;
+        return PrintOptions();
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrintOptions()
+{
+    std::cout << std::endl
+              << "./bin/LArRecoGapLookupBenchmark " << std::endl
+              << "    -g GeometryFile        (required) [detector geometry description: xml/pndr]" << std::endl
+              << "    -n NPositions          (optional) [no. of random positions looked up in each view and in 3D, default 1000000]" << std::endl
+              << "    -t GapTolerance        (optional) [cm, default 0]" << std::endl
+              << "    -r Seed                (optional) [random number seed, default 12345]" << std::endl
+              << std::endl;
+
+    return false;
+}
+
+} // namespace lar_reco
@@ -0,0 +1,85 @@
+/**
+ *  @file   LArReco/benchmark/GapLookupBenchmark.h
+ *
+ *  @brief  Header file for the gap lookup benchmark, comparing the detector gap index with iteration over every detector gap
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_GAP_LOOKUP_BENCHMARK_H
+#define LAR_RECO_GAP_LOOKUP_BENCHMARK_H 1
+
+#include "Pandora/PandoraInternal.h"
+
+#include <string>
+#include <vector>
+
+namespace pandora
+{
+class Pandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  GapLookupParameters class
+ */
+class GapLookupParameters
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    GapLookupParameters();
+
+    std::string     m_geometryFileName;         ///< The detector geometry description, xml or pndr
+    int             m_nPositions;               ///< The number of random positions to look up in each view
+    float           m_gapTolerance;             ///< The tolerance with which to test each gap, cm
+    unsigned int    m_seed;                     ///< The random number seed
+};
+
+/**
+ *  @brief  Time the lookup of random positions in a view, or in 3D, by iterating over every gap and by using the detector gap index
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  pandora the pandora instance holding the geometry
+ *  @param  hitType the view, or 3D
+ *
+ *  @return the number of positions for which the two lookups disagree
+ */
+unsigned int RunGapLookupBenchmark(const GapLookupParameters &parameters, const pandora::Pandora &pandora, const pandora::HitType hitType);
+
+/**
+ *  @brief  Parse the command line arguments, setting the benchmark parameters
+ *
+ *  @param  argc argument count
+ *  @param  argv argument vector
+ *  @param  parameters to receive the benchmark parameters
+ *
+ *  @return success
+ */
+bool ParseCommandLine(int argc, char *argv[], GapLookupParameters &parameters);
+
+/**
+ *  @brief  Print the list of configurable options
+ *
+ *  @return false, to force abort
+ */
+bool PrintOptions();
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline GapLookupParameters::GapLookupParameters() :
+    m_geometryFileName(""),
+    m_nPositions(1000000),
+    m_gapTolerance(0.f),
+    m_seed(12345)
+{
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_GAP_LOOKUP_BENCHMARK_H
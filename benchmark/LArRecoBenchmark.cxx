@@ -0,0 +1,645 @@
+/**
+ *  @file   LArReco/benchmark/LArRecoBenchmark.cxx
+ *
+ *  @brief  Implementation of the lar reco benchmark application, measuring the throughput of each master settings file and reco option
+ *
+ *  $Log: $
+ */
+
+#include "LArRecoBenchmark.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace lar_reco;
+
+namespace
+{
+
+/**
+ *  @brief  Get a percentile of a list of values, using the nearest-rank method
+ *
+ *  @param  sortedValues the values, in ascending order
+ *  @param  percentile the percentile
+ *
+ *  @return the value at the percentile
+ */
+double GetPercentile(const std::vector<double> &sortedValues, const double percentile)
+{
+    if (sortedValues.empty())
+        return 0.;
+
+    const std::size_t rank(static_cast<std::size_t>(percentile / 100. * sortedValues.size() + 0.999999));
+    return sortedValues.at(std::min(std::max(rank, std::size_t(1)), sortedValues.size()) - 1);
+}
+
+/**
+ *  @brief  Get the value of a field in a single-line json object, as written by WriteResults
+ *
+ *  @param  line the line
+ *  @param  key the field name
+ *  @param  value to receive the value, without quotes
+ *
+ *  @return whether the field was found
+ */
+bool GetJsonValue(const std::string &line, const std::string &key, std::string &value)
+{
+    const std::string keyString("\"" + key + "\": ");
+    const std::string::size_type keyPosition(line.find(keyString));
+
+    if (std::string::npos == keyPosition)
+        return false;
+
+    const std::string::size_type valuePosition(keyPosition + keyString.size());
+
+    if ((valuePosition < line.size()) && ('"' == line.at(valuePosition)))
+    {
+        const std::string::size_type endPosition(line.find('"', valuePosition + 1));
+
+        if (std::string::npos == endPosition)
+            return false;
+
+        value = line.substr(valuePosition + 1, endPosition - valuePosition - 1);
+        return true;
+    }
+
+    const std::string::size_type endPosition(line.find_first_of(",}", valuePosition));
+    value = line.substr(valuePosition, (std::string::npos == endPosition) ? std::string::npos : endPosition - valuePosition);
+    return !value.empty();
+}
+
+/**
+ *  @brief  Get the relative change of a value with respect to a baseline value
+ *
+ *  @param  value the value
+ *  @param  baselineValue the baseline value
+ *
+ *  @return the relative change, or zero if the baseline value is not positive
+ */
+double GetRelativeChange(const double value, const double baselineValue)
+{
+    return ((baselineValue > 0.) ? (value - baselineValue) / baselineValue : 0.);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    BenchmarkParameters parameters;
+
+    if (!ParseCommandLine(argc, argv, parameters))
+        return 1;
+
+    BenchmarkConfigurationList configurationList;
+
+    if (!ReadConfigurations(parameters.m_configurationFile, configurationList))
+        return 1;
+
+    // ATTN The named cosmic, neutrino and slicing settings files are located via FW_SEARCH_PATH
+    const char *const pSearchPath(std::getenv("FW_SEARCH_PATH"));
+    const std::string searchPath(parameters.m_settingsDirectory + (pSearchPath ? ":" + std::string(pSearchPath) : ""));
+    ::setenv("FW_SEARCH_PATH", searchPath.c_str(), 1);
+
+    BenchmarkResultList resultList;
+
+    for (const BenchmarkConfiguration &configuration : configurationList)
+    {
+        for (const std::string &recoOption : parameters.m_recoOptionVector)
+        {
+            for (const bool shouldReleaseEventMemory : {false, true})
+            {
+                if (shouldReleaseEventMemory && !parameters.m_shouldCompareAllocators)
+                    continue;
+
+                BenchmarkResult result;
+                RunBenchmark(parameters, configuration, recoOption, shouldReleaseEventMemory, result);
+                resultList.push_back(result);
+            }
+        }
+    }
+
+    if (!WriteResults(parameters.m_outputFile, resultList))
+        return 1;
+
+    // ATTN With no baseline file, the results are recorded as the baseline, rather than compared, provided every benchmark succeeded
+    if (!parameters.m_baselineFile.empty() && (0 != ::access(parameters.m_baselineFile.c_str(), F_OK)))
+    {
+        const bool isEverySuccess(
+            std::all_of(resultList.begin(), resultList.end(), [](const BenchmarkResult &result) { return result.m_isSuccess; }));
+
+        if (isEverySuccess && !WriteResults(parameters.m_baselineFile, resultList))
+            return 1;
+
+        std::cout << "LArRecoBenchmark, no baseline at " << parameters.m_baselineFile
+                  << (isEverySuccess ? ", results recorded as the baseline" : ", results not recorded as the baseline, as benchmarks failed")
+                  << std::endl;
+        parameters.m_baselineFile.clear();
+    }
+
+    BenchmarkResultMap baselineMap;
+    const bool isBaselineMissing(!parameters.m_baselineFile.empty() && !ReadBaseline(parameters.m_baselineFile, baselineMap));
+    const unsigned int nRegressions(CompareToBaseline(parameters, resultList, baselineMap));
+
+    if (isBaselineMissing)
+        std::cout << "LArRecoBenchmark, ERROR no baseline read from " << parameters.m_baselineFile << ", results are not compared" << std::endl;
+
+    return (((nRegressions > 0) || isBaselineMissing) ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+void RunBenchmark(const BenchmarkParameters &parameters, const BenchmarkConfiguration &configuration, const std::string &recoOption,
+    const bool shouldReleaseEventMemory, BenchmarkResult &result)
+{
+    const std::string inputFile(parameters.m_inputDirectory + "/" + configuration.m_inputName + ".pndr");
+    const std::string settingsName(configuration.m_settingsFile.substr(0, configuration.m_settingsFile.find_last_of('.')));
+    result.m_name = settingsName + "/" + recoOption + (shouldReleaseEventMemory ? "/ReleaseEventMemory" : "");
+
+    if (0 != ::access(inputFile.c_str(), R_OK))
+    {
+        std::cout << "LArRecoBenchmark, ERROR no input " << inputFile << ", " << result.m_name << " fails" << std::endl;
+        return;
+    }
+
+    BenchmarkStringVector argumentVector{
+        "-r", recoOption, "-i", parameters.m_settingsDirectory + "/" + configuration.m_settingsFile, "-e", inputFile};
+
+    if (!configuration.m_geometryFile.empty())
+    {
+        argumentVector.push_back("-g");
+        argumentVector.push_back(
+            parameters.m_geometryDirectory.empty() ? configuration.m_geometryFile : parameters.m_geometryDirectory + "/" + configuration.m_geometryFile);
+    }
+
+    if (shouldReleaseEventMemory)
+        argumentVector.push_back("-A");
+
+    // ATTN Startup, creating the pandora instances and reading settings and geometry, is timed by a run processing no events and subtracted
+    BenchmarkStringVector startupArgumentVector(argumentVector);
+    startupArgumentVector.insert(startupArgumentVector.end(), {"-n", "0"});
+    argumentVector.insert(argumentVector.end(), {"-n", std::to_string(parameters.m_nEvents)});
+
+    std::string runName(result.m_name);
+    std::replace(runName.begin(), runName.end(), '/', '_');
+    const std::string runDirectory(parameters.m_workingDirectory + "/" + runName);
+
+    if ((0 != ::mkdir(runDirectory.c_str(), 0755)) && (EEXIST != errno))
+    {
+        std::cout << "LArRecoBenchmark, unable to create run directory " << runDirectory << std::endl;
+        return;
+    }
+
+    std::cout << "LArRecoBenchmark, running " << result.m_name << std::endl;
+
+    // ATTN Algorithm timing adds to each event, so per-event latencies come from a separate breakdown run and only plain runs are timed
+    BenchmarkStringVector breakdownArgumentVector(argumentVector);
+    breakdownArgumentVector.insert(breakdownArgumentVector.end(), {"-T", "Timing.csv"});
+
+    long peakRssKB(0);
+    double wallTime(0.);
+
+    if (!RunPandoraInterface(parameters, breakdownArgumentVector, runDirectory, peakRssKB, wallTime))
+    {
+        std::cout << "LArRecoBenchmark, " << result.m_name << " failed, see " << runDirectory << "/PandoraInterface.log" << std::endl;
+        return;
+    }
+
+    std::vector<double> eventTimeVector;
+    ReadEventTimes(runDirectory + "/Timing.csv", eventTimeVector);
+
+    if (eventTimeVector.empty())
+    {
+        std::cout << "LArRecoBenchmark, " << result.m_name << " processed no events, see " << runDirectory << "/PandoraInterface.log" << std::endl;
+        return;
+    }
+
+    std::vector<double> eventsPerSecondVector;
+
+    for (int iRepeat = 0; iRepeat < parameters.m_nRepeats; ++iRepeat)
+    {
+        long startupPeakRssKB(0);
+        double startupWallTime(0.);
+
+        if (!RunPandoraInterface(parameters, startupArgumentVector, runDirectory, startupPeakRssKB, startupWallTime) ||
+            !RunPandoraInterface(parameters, argumentVector, runDirectory, peakRssKB, wallTime))
+        {
+            std::cout << "LArRecoBenchmark, " << result.m_name << " failed, see " << runDirectory << "/PandoraInterface.log" << std::endl;
+            return;
+        }
+
+        if (wallTime > startupWallTime)
+            eventsPerSecondVector.push_back(eventTimeVector.size() / (wallTime - startupWallTime));
+
+        result.m_peakRssKB = std::max(result.m_peakRssKB, peakRssKB);
+    }
+
+    std::sort(eventTimeVector.begin(), eventTimeVector.end());
+    std::sort(eventsPerSecondVector.begin(), eventsPerSecondVector.end());
+
+    result.m_isSuccess = true;
+    result.m_nEvents = eventTimeVector.size();
+    result.m_eventsPerSecond = GetPercentile(eventsPerSecondVector, 50.);
+    result.m_p50Time = GetPercentile(eventTimeVector, 50.);
+    result.m_p99Time = GetPercentile(eventTimeVector, 99.);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool RunPandoraInterface(const BenchmarkParameters &parameters, const BenchmarkStringVector &argumentVector, const std::string &runDirectory,
+    long &peakRssKB, double &wallTime)
+{
+    const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+    const pid_t pid(::fork());
+
+    if (pid < 0)
+        return false;
+
+    if (0 == pid)
+    {
+        const std::string logFileName(runDirectory + "/PandoraInterface.log");
+        const int logFile(::open(logFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+
+        if ((logFile < 0) || (0 != ::chdir(runDirectory.c_str())))
+            ::_exit(127);
+
+        ::dup2(logFile, STDOUT_FILENO);
+        ::dup2(logFile, STDERR_FILENO);
+        ::close(logFile);
+
+        std::vector<char *> argv{const_cast<char *>(parameters.m_executable.c_str())};
+
+        for (const std::string &argument : argumentVector)
+            argv.push_back(const_cast<char *>(argument.c_str()));
+
+        argv.push_back(nullptr);
+        ::execv(parameters.m_executable.c_str(), argv.data());
+        ::_exit(127);
+    }
+
+    int status(0);
+    struct rusage resourceUsage;
+
+    if (::wait4(pid, &status, 0, &resourceUsage) != pid)
+        return false;
+
+    wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // On Linux the maximum resident set size is reported in kB
+    peakRssKB = resourceUsage.ru_maxrss;
+
+    return (WIFEXITED(status) && (0 == WEXITSTATUS(status)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ReadEventTimes(const std::string &timingFileName, std::vector<double> &eventTimeVector)
+{
+    std::ifstream timingFile(timingFileName);
+    std::string line, previousEventPrefix;
+
+    while (std::getline(timingFile, line))
+    {
+        // Lines are fileName,eventNumber,instance,algorithm,calls,seconds, with one Event,Read and one Event,Process line per event
+        const std::string::size_type readPosition(line.find(",Event,Read,"));
+        const std::string::size_type processPosition(line.find(",Event,Process,"));
+        const std::string::size_type tagPosition((std::string::npos != readPosition) ? readPosition : processPosition);
+
+        if (std::string::npos == tagPosition)
+            continue;
+
+        const double seconds(std::atof(line.substr(line.find_last_of(',') + 1).c_str()));
+        const std::string eventPrefix(line.substr(0, tagPosition));
+
+        if (eventTimeVector.empty() || (eventPrefix != previousEventPrefix))
+        {
+            eventTimeVector.push_back(seconds);
+        }
+        else
+        {
+            eventTimeVector.back() += seconds;
+        }
+
+        previousEventPrefix = eventPrefix;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ReadConfigurations(const std::string &configurationFile, BenchmarkConfigurationList &configurationList)
+{
+    std::ifstream inputFile(configurationFile);
+
+    if (!inputFile.is_open())
+    {
+        std::cout << "LArRecoBenchmark, unable to open configuration file " << configurationFile << std::endl;
+        return false;
+    }
+
+    std::string line;
+
+    while (std::getline(inputFile, line))
+    {
+        // Each line holds: <MasterSettingsFile> <InputName> [<GeometryFile>], with # introducing a comment
+        line = line.substr(0, line.find('#'));
+        std::istringstream lineStream(line);
+        BenchmarkConfiguration configuration;
+
+        if (!(lineStream >> configuration.m_settingsFile))
+            continue;
+
+        if (!(lineStream >> configuration.m_inputName))
+        {
+            std::cout << "LArRecoBenchmark, no input named for configuration " << configuration.m_settingsFile << std::endl;
+            return false;
+        }
+
+        lineStream >> configuration.m_geometryFile;
+        configurationList.push_back(configuration);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool WriteResults(const std::string &outputFile, const BenchmarkResultList &resultList)
+{
+    std::ofstream jsonFile(outputFile, std::ios::trunc);
+
+    if (!jsonFile.is_open())
+    {
+        std::cout << "LArRecoBenchmark, unable to write results to " << outputFile << std::endl;
+        return false;
+    }
+
+    jsonFile << "{\"benchmarks\": [";
+
+    for (BenchmarkResultList::const_iterator iter = resultList.begin(); iter != resultList.end(); ++iter)
+    {
+        // ATTN One benchmark per line, as expected by ReadBaseline
+        jsonFile << ((resultList.begin() == iter) ? "" : ",") << std::endl
+                 << "  {\"name\": \"" << iter->m_name << "\", \"success\": " << (iter->m_isSuccess ? "true" : "false")
+                 << ", \"nEvents\": " << iter->m_nEvents << ", \"eventsPerSecond\": " << iter->m_eventsPerSecond
+                 << ", \"p50Seconds\": " << iter->m_p50Time << ", \"p99Seconds\": " << iter->m_p99Time << ", \"peakRssKB\": " << iter->m_peakRssKB
+                 << "}";
+    }
+
+    jsonFile << std::endl << "]}" << std::endl;
+
+    std::cout << "LArRecoBenchmark, results written to " << outputFile << std::endl;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ReadBaseline(const std::string &baselineFile, BenchmarkResultMap &baselineMap)
+{
+    std::ifstream jsonFile(baselineFile);
+
+    if (!jsonFile.is_open())
+        return false;
+
+    std::string line;
+
+    while (std::getline(jsonFile, line))
+    {
+        BenchmarkResult result;
+        std::string success, nEvents, eventsPerSecond, p50Time, p99Time, peakRssKB;
+
+        if (!GetJsonValue(line, "name", result.m_name) || !GetJsonValue(line, "success", success) || !GetJsonValue(line, "nEvents", nEvents) ||
+            !GetJsonValue(line, "eventsPerSecond", eventsPerSecond) || !GetJsonValue(line, "p50Seconds", p50Time) ||
+            !GetJsonValue(line, "p99Seconds", p99Time) || !GetJsonValue(line, "peakRssKB", peakRssKB))
+        {
+            continue;
+        }
+
+        result.m_isSuccess = ("true" == success);
+        result.m_nEvents = std::atoi(nEvents.c_str());
+        result.m_eventsPerSecond = std::atof(eventsPerSecond.c_str());
+        result.m_p50Time = std::atof(p50Time.c_str());
+        result.m_p99Time = std::atof(p99Time.c_str());
+        result.m_peakRssKB = std::atol(peakRssKB.c_str());
+        baselineMap[result.m_name] = result;
+    }
+
+    return !baselineMap.empty();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int CompareToBaseline(const BenchmarkParameters &parameters, const BenchmarkResultList &resultList, const BenchmarkResultMap &baselineMap)
+{
+    unsigned int nRegressions(0), nMissingBaselines(0);
+
+    std::cout << std::endl
+              << std::left << std::setw(64) << "Benchmark" << std::right << std::setw(10) << "events/s" << std::setw(12) << "p50 ms" << std::setw(12)
+              << "p99 ms" << std::setw(12) << "peak MB" << "  (change vs baseline)" << std::endl;
+
+    for (const BenchmarkResult &result : resultList)
+    {
+        std::cout << std::left << std::setw(64) << result.m_name << std::right;
+
+        if (!result.m_isSuccess)
+        {
+            std::cout << "  FAILED" << std::endl;
+            ++nRegressions;
+            continue;
+        }
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(10) << result.m_eventsPerSecond << std::setw(12) << (1000. * result.m_p50Time)
+                  << std::setw(12) << (1000. * result.m_p99Time) << std::setw(12) << (result.m_peakRssKB / 1024.);
+
+        const BenchmarkResultMap::const_iterator baselineIter(baselineMap.find(result.m_name));
+
+        if (baselineMap.end() == baselineIter)
+        {
+            std::cout << std::defaultfloat << (parameters.m_baselineFile.empty() ? "" : "  NO BASELINE") << std::endl;
+            ++nMissingBaselines;
+            continue;
+        }
+
+        const BenchmarkResult &baseline(baselineIter->second);
+
+        // ATTN Results for a different number of events measure different work, so cannot be compared
+        if (result.m_nEvents != baseline.m_nEvents)
+        {
+            std::cout << std::defaultfloat << "  EVENT COUNT CHANGED FROM " << baseline.m_nEvents << std::endl;
+            ++nRegressions;
+            continue;
+        }
+
+        // ATTN Regressions are a fall in throughput, or a rise in latency or memory
+        const std::vector<double> changeVector{-GetRelativeChange(result.m_eventsPerSecond, baseline.m_eventsPerSecond),
+            GetRelativeChange(result.m_p50Time, baseline.m_p50Time), GetRelativeChange(result.m_p99Time, baseline.m_p99Time),
+            GetRelativeChange(static_cast<double>(result.m_peakRssKB), static_cast<double>(baseline.m_peakRssKB))};
+
+        const bool isRegression(std::any_of(changeVector.begin(), changeVector.end(), [&](const double change) { return (change > parameters.m_tolerance); }));
+
+        std::cout << std::showpos << std::setprecision(1) << "  (" << (-100. * changeVector.at(0)) << "%, " << (100. * changeVector.at(1)) << "%, "
+                  << (100. * changeVector.at(2)) << "%, " << (100. * changeVector.at(3)) << "%)" << std::noshowpos << std::defaultfloat
+                  << (isRegression ? "  REGRESSION" : "") << std::endl;
+
+        if (isRegression)
+            ++nRegressions;
+    }
+
+    std::cout << std::endl << "LArRecoBenchmark, " << resultList.size() << " benchmarks, " << nRegressions << " regressions or failures";
+
+    if (!parameters.m_baselineFile.empty())
+        std::cout << ", " << nMissingBaselines << " without baseline";
+
+    std::cout << std::endl;
+
+    return nRegressions;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ParseCommandLine(int argc, char *argv[], BenchmarkParameters &parameters)
+{
+    if (1 == argc)
+        return PrintOptions();
+
+    int c(0);
+    std::string recoOptionList;
+
+    while ((c = getopt(argc, argv, "x:c:s:g:d:b:o:w:r:n:k:f:Ah")) != -1)
+    {
+        switch (c)
+        {
+            case 'x':
+                parameters.m_executable = optarg;
+                break;
+            case 'c':
+                parameters.m_configurationFile = optarg;
+                break;
+            case 's':
+                parameters.m_settingsDirectory = optarg;
+                break;
+            case 'g':
+                parameters.m_geometryDirectory = optarg;
+                break;
+            case 'd':
+                parameters.m_inputDirectory = optarg;
+                break;
+            case 'b':
+                parameters.m_baselineFile = optarg;
+                break;
+            case 'o':
+                parameters.m_outputFile = optarg;
+                break;
+            case 'w':
+                parameters.m_workingDirectory = optarg;
+                break;
+            case 'r':
+                recoOptionList = optarg;
+                break;
+            case 'n':
+                parameters.m_nEvents = std::atoi(optarg);
+                break;
+            case 'k':
+                parameters.m_nRepeats = std::atoi(optarg);
+                break;
+            case 'f':
+                parameters.m_tolerance = std::atof(optarg);
+                break;
+            case 'A':
+                parameters.m_shouldCompareAllocators = true;
+                break;
+            case 'h':
+            default:
+                return PrintOptions();
+        }
+    }
+
+    if (!recoOptionList.empty())
+    {
+        parameters.m_recoOptionVector.clear();
+        std::istringstream recoOptionStream(recoOptionList);
+        std::string recoOption;
+
+        while (std::getline(recoOptionStream, recoOption, ':'))
+            parameters.m_recoOptionVector.push_back(recoOption);
+    }
+
+    if (parameters.m_executable.empty() || parameters.m_configurationFile.empty() || parameters.m_settingsDirectory.empty() ||
+        parameters.m_inputDirectory.empty())
+    {
+        std::cout << "LArRecoBenchmark, the executable, configuration file, settings directory and input directory are required" << std::endl;
+        return PrintOptions();
+    }
+
+    if ((parameters.m_nEvents < 1) || (parameters.m_nRepeats < 1) || (parameters.m_tolerance < 0.))
+    {
+        std::cout << "LArRecoBenchmark, invalid number of events, repeats or tolerance" << std::endl;
+        return PrintOptions();
+    }
+
+    if ((0 != ::mkdir(parameters.m_workingDirectory.c_str(), 0755)) && (EEXIST != errno))
+    {
+        std::cout << "LArRecoBenchmark, unable to create working directory " << parameters.m_workingDirectory << std::endl;
+        return false;
+    }
+
+    // ATTN Paths are made absolute, as each benchmark is run from its own directory
+    for (std::string *const pPath : {&parameters.m_executable, &parameters.m_settingsDirectory, &parameters.m_geometryDirectory,
+             &parameters.m_inputDirectory, &parameters.m_workingDirectory})
+    {
+        char *const pAbsolutePath(pPath->empty() ? nullptr : ::realpath(pPath->c_str(), nullptr));
+
+        if (pAbsolutePath)
+        {
+            *pPath = pAbsolutePath;
+            std::free(pAbsolutePath);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrintOptions()
+{
+    std::cout << std::endl
+              << "./bin/LArRecoBenchmark " << std::endl
+              << "    -x Executable          (required) [path to PandoraInterface]" << std::endl
+              << "    -c ConfigurationFile   (required) [lines of: MasterSettingsFile InputName [GeometryFile]]" << std::endl
+              << "    -s SettingsDirectory   (required) [directory containing the settings files]" << std::endl
+              << "    -d InputDirectory      (required) [directory containing the fixed input, <InputName>.pndr]" << std::endl
+              << "    -g GeometryDirectory   (optional) [directory containing the geometry files]" << std::endl
+              << "    -b BaselineFile        (optional) [results json against which to flag regressions, recorded if absent]" << std::endl
+              << "    -o OutputFile          (optional) [results json, default LArRecoBenchmarkResults.json]" << std::endl
+              << "    -w WorkingDirectory    (optional) [directory for run logs and timings, default LArRecoBenchmarkRuns]" << std::endl
+              << "    -r RecoOptionList      (optional) [colon-separated reco options, default all]" << std::endl
+              << "    -n NEvents             (optional) [no. of events per run, default 20]" << std::endl
+              << "    -k NRepeats            (optional) [no. of timed runs per benchmark, each less a run of no events, default 1]"
+              << std::endl
+              << "    -f Tolerance           (optional) [fractional change flagged as regression, default 0.1]" << std::endl
+              << "    -A                     (optional) [also run each benchmark with release of event memory, -A]" << std::endl
+              << std::endl;
+
+    return false;
+}
+
+} // namespace lar_reco
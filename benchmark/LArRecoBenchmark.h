@@ -0,0 +1,213 @@
+/**
+ *  @file   LArReco/benchmark/LArRecoBenchmark.h
+ *
+ *  @brief  Header file for the lar reco benchmark application, measuring the throughput of each master settings file and reco option
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_BENCHMARK_H
+#define LAR_RECO_BENCHMARK_H 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+typedef std::vector<std::string> BenchmarkStringVector;
+
+/**
+ *  @brief  BenchmarkParameters class
+ */
+class BenchmarkParameters
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    BenchmarkParameters();
+
+    std::string             m_executable;               ///< The path to the PandoraInterface executable
+    std::string             m_configurationFile;        ///< The file listing the settings, input and geometry of each configuration
+    std::string             m_settingsDirectory;        ///< The directory containing the settings files
+    std::string             m_geometryDirectory;        ///< The directory containing the geometry files
+    std::string             m_inputDirectory;           ///< The directory containing the fixed input event files, <InputName>.pndr
+    std::string             m_baselineFile;             ///< The baseline results, against which to flag regressions, recorded if absent
+    std::string             m_outputFile;               ///< The file to receive the results, json
+    std::string             m_workingDirectory;         ///< The directory in which to run each benchmark
+    BenchmarkStringVector   m_recoOptionVector;         ///< The reco options with which to run each configuration
+    int                     m_nEvents;                  ///< The number of events to process in each run
+    int                     m_nRepeats;                 ///< The number of runs of each benchmark
+    double                  m_tolerance;                ///< The fractional change relative to the baseline that is flagged as a regression
+    bool                    m_shouldCompareAllocators;  ///< Whether to run each benchmark with and without release of event memory
+};
+
+/**
+ *  @brief  BenchmarkConfiguration class
+ */
+class BenchmarkConfiguration
+{
+public:
+    std::string     m_settingsFile;     ///< The master settings file name
+    std::string     m_inputName;        ///< The name of the input event file, without directory or extension
+    std::string     m_geometryFile;     ///< The geometry file name, empty if the geometry is read from the input
+};
+
+typedef std::vector<BenchmarkConfiguration> BenchmarkConfigurationList;
+
+/**
+ *  @brief  BenchmarkResult class
+ */
+class BenchmarkResult
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    BenchmarkResult();
+
+    std::string     m_name;             ///< The benchmark name, <settings>/<recoOption>[/ReleaseEventMemory]
+    bool            m_isSuccess;        ///< Whether every run of the benchmark completed
+    unsigned int    m_nEvents;          ///< The number of events processed in each run
+    double          m_eventsPerSecond;  ///< The median over timed runs of the events processed per second, excluding startup
+    double          m_p50Time;          ///< The median per-event latency in the breakdown run, read plus process time, in seconds
+    double          m_p99Time;          ///< The 99th percentile per-event latency in the breakdown run, in seconds
+    long            m_peakRssKB;        ///< The largest peak resident memory of any timed run, in kB
+};
+
+typedef std::vector<BenchmarkResult> BenchmarkResultList;
+typedef std::map<std::string, BenchmarkResult> BenchmarkResultMap;
+
+/**
+ *  @brief  Run a benchmark, for a single configuration and reco option. One breakdown run, with algorithm timing, provides the per-event
+ *          latencies, then the throughput and peak memory are measured over plain timed runs, with the wall time of a run processing
+ *          no events subtracted from each, so that startup is excluded. A benchmark whose input is missing fails.
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  configuration the configuration
+ *  @param  recoOption the reco option
+ *  @param  shouldReleaseEventMemory whether to run with release of event memory
+ *  @param  result to receive the result
+ */
+void RunBenchmark(const BenchmarkParameters &parameters, const BenchmarkConfiguration &configuration, const std::string &recoOption,
+    const bool shouldReleaseEventMemory, BenchmarkResult &result);
+
+/**
+ *  @brief  Run PandoraInterface in a child process, in the specified directory, with output redirected to a log file
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  argumentVector the arguments, excluding the executable
+ *  @param  runDirectory the directory in which to run
+ *  @param  peakRssKB to receive the peak resident memory of the child process, in kB
+ *  @param  wallTime to receive the wall time of the child process, in seconds
+ *
+ *  @return whether the child process completed successfully
+ */
+bool RunPandoraInterface(const BenchmarkParameters &parameters, const BenchmarkStringVector &argumentVector, const std::string &runDirectory,
+    long &peakRssKB, double &wallTime);
+
+/**
+ *  @brief  Read the per-event latencies, read plus process time, from a PandoraInterface timing file
+ *
+ *  @param  timingFileName the timing file name
+ *  @param  eventTimeVector to receive the per-event latencies, in seconds
+ */
+void ReadEventTimes(const std::string &timingFileName, std::vector<double> &eventTimeVector);
+
+/**
+ *  @brief  Read the benchmark configurations
+ *
+ *  @param  configurationFile the configuration file
+ *  @param  configurationList to receive the configurations
+ *
+ *  @return success
+ */
+bool ReadConfigurations(const std::string &configurationFile, BenchmarkConfigurationList &configurationList);
+
+/**
+ *  @brief  Write the benchmark results as json
+ *
+ *  @param  outputFile the output file
+ *  @param  resultList the results
+ *
+ *  @return success
+ */
+bool WriteResults(const std::string &outputFile, const BenchmarkResultList &resultList);
+
+/**
+ *  @brief  Read baseline results, as written by WriteResults
+ *
+ *  @param  baselineFile the baseline file
+ *  @param  baselineMap to receive the baseline results, indexed by name
+ *
+ *  @return success
+ */
+bool ReadBaseline(const std::string &baselineFile, BenchmarkResultMap &baselineMap);
+
+/**
+ *  @brief  Print the results, with the change relative to any baseline, flagging regressions beyond the tolerance, changes in the number
+ *          of events and results missing from the baseline
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  resultList the results
+ *  @param  baselineMap the baseline results, indexed by name
+ *
+ *  @return the number of regressions and failures
+ */
+unsigned int CompareToBaseline(const BenchmarkParameters &parameters, const BenchmarkResultList &resultList, const BenchmarkResultMap &baselineMap);
+
+/**
+ *  @brief  Parse the command line arguments, setting the benchmark parameters
+ *
+ *  @param  argc argument count
+ *  @param  argv argument vector
+ *  @param  parameters to receive the benchmark parameters
+ *
+ *  @return success
+ */
+bool ParseCommandLine(int argc, char *argv[], BenchmarkParameters &parameters);
+
+/**
+ *  @brief  Print the list of configurable options
+ *
+ *  @return false, to force abort
+ */
+bool PrintOptions();
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline BenchmarkParameters::BenchmarkParameters() :
+    m_executable(""),
+    m_configurationFile(""),
+    m_settingsDirectory(""),
+    m_geometryDirectory(""),
+    m_inputDirectory(""),
+    m_baselineFile(""),
+    m_outputFile("LArRecoBenchmarkResults.json"),
+    m_workingDirectory("LArRecoBenchmarkRuns"),
+    m_recoOptionVector{"Full", "AllHitsCR", "AllHitsNu", "CRRemHitsSliceCR", "CRRemHitsSliceNu", "AllHitsSliceCR", "AllHitsSliceNu"},
+    m_nEvents(20),
+    m_nRepeats(1),
+    m_tolerance(0.1),
+    m_shouldCompareAllocators(false)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline BenchmarkResult::BenchmarkResult() :
+    m_name(""),
+    m_isSuccess(false),
+    m_nEvents(0),
+    m_eventsPerSecond(0.),
+    m_p50Time(0.),
+    m_p99Time(0.),
+    m_peakRssKB(0)
+{
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_BENCHMARK_H
@@ -0,0 +1,538 @@
+/**
+ *  @file   LArReco/benchmark/SyntheticEventGenerator.cxx
+ *
+ *  @brief  Implementation of the synthetic event generator, writing events for a detector geometry description
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Geometry/LArTPC.h"
+#include "Managers/GeometryManager.h"
+#include "Persistency/XmlFileReader.h"
+
+#include "larpandoracontent/LArContent.h"
+#include "larpandoracontent/LArPlugins/LArPseudoLayerPlugin.h"
+#include "larpandoracontent/LArPlugins/LArRotationalTransformationPlugin.h"
+
+#include "SyntheticEventGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include <getopt.h>
+
+using namespace pandora;
+using namespace lar_reco;
+
+namespace
+{
+
+const float MIP_DEDX(0.0021f);          ///< The energy deposited per unit length by a minimum ionising particle, GeV/cm
+const float HIT_WIDTH(0.5f);            ///< The extent of each hit in the drift coordinate, cm
+const float VERTEX_MARGIN(10.f);        ///< The minimum distance from a neutrino vertex to the faces of its lar tpc, cm
+const int N_SHOWER_BRANCHES(10);        ///< The number of branching segments in each shower
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    int errorNo(0);
+    const Pandora *pPandora(nullptr);
+
+    try
+    {
+        GeneratorParameters parameters;
+
+        if (!ParseCommandLine(argc, argv, parameters))
+            return 1;
+
+        pPandora = new Pandora();
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArContent::RegisterAlgorithms(*pPandora));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArContent::RegisterBasicPlugins(*pPandora));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetPseudoLayerPlugin(*pPandora, new lar_content::LArPseudoLayerPlugin));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=,
+            PandoraApi::SetLArTransformationPlugin(*pPandora, new lar_content::LArRotationalTransformationPlugin));
+
+        XmlFileReader geometryFileReader(*pPandora, parameters.m_geometryFileName);
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, geometryFileReader.ReadGeometry());
+
+        // ATTN Events are written by the LArEventWriting algorithm, configured to write the hits and mc particles created for each event
+        const std::string settingsFileName(parameters.m_outputFileName + ".GeneratorSettings.xml");
+        WriteEventWritingSettings(parameters, settingsFileName);
+        const StatusCode settingsStatusCode(PandoraApi::ReadSettings(*pPandora, settingsFileName));
+        std::remove(settingsFileName.c_str());
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, settingsStatusCode);
+
+        SyntheticEventGenerator syntheticEventGenerator(*pPandora, parameters);
+        unsigned int nHitsU(0), nHitsV(0), nHitsW(0);
+
+        for (int iEvent = 0; iEvent < parameters.m_nEvents; ++iEvent)
+        {
+            syntheticEventGenerator.GenerateEvent();
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::ProcessEvent(*pPandora));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPandora));
+
+            nHitsU += syntheticEventGenerator.GetNHits(TPC_VIEW_U);
+            nHitsV += syntheticEventGenerator.GetNHits(TPC_VIEW_V);
+            nHitsW += syntheticEventGenerator.GetNHits(TPC_VIEW_W);
+        }
+
+        const float nEvents(std::max(parameters.m_nEvents, 1));
+        std::cout << "LArRecoEventGenerator, wrote " << parameters.m_nEvents << " events to " << parameters.m_outputFileName
+                  << ", mean hits per event U " << (nHitsU / nEvents) << ", V " << (nHitsV / nEvents) << ", W " << (nHitsW / nEvents) << std::endl;
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << statusCodeException.GetBackTrace() << std::endl;
+        errorNo = 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception: " << std::endl;
+        errorNo = 1;
+    }
+
+    // ATTN The event file is only complete once the pandora instance, and its event writing algorithm, have been deleted
+    delete pPandora;
+
+    return errorNo;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+SyntheticEventGenerator::SyntheticEventGenerator(const Pandora &pandora, const GeneratorParameters &parameters) :
+    m_pandora(pandora),
+    m_parameters(parameters),
+    m_detectorGapIndex(pandora.GetGeometry()->GetDetectorGapList(), 0.f),
+    m_minX(std::numeric_limits<float>::max()),
+    m_maxX(-std::numeric_limits<float>::max()),
+    m_minY(std::numeric_limits<float>::max()),
+    m_maxY(-std::numeric_limits<float>::max()),
+    m_minZ(std::numeric_limits<float>::max()),
+    m_maxZ(-std::numeric_limits<float>::max()),
+    m_randomEngine(parameters.m_seed),
+    m_nAddresses(0),
+    m_nHitsU(0),
+    m_nHitsV(0),
+    m_nHitsW(0)
+{
+    for (const LArTPCMap::value_type &mapEntry : m_pandora.GetGeometry()->GetLArTPCMap())
+    {
+        const LArTPC *const pLArTPC(mapEntry.second);
+        m_larTPCVector.push_back(pLArTPC);
+
+        m_minX = std::min(m_minX, pLArTPC->GetCenterX() - 0.5f * pLArTPC->GetWidthX());
+        m_maxX = std::max(m_maxX, pLArTPC->GetCenterX() + 0.5f * pLArTPC->GetWidthX());
+        m_minY = std::min(m_minY, pLArTPC->GetCenterY() - 0.5f * pLArTPC->GetWidthY());
+        m_maxY = std::max(m_maxY, pLArTPC->GetCenterY() + 0.5f * pLArTPC->GetWidthY());
+        m_minZ = std::min(m_minZ, pLArTPC->GetCenterZ() - 0.5f * pLArTPC->GetWidthZ());
+        m_maxZ = std::max(m_maxZ, pLArTPC->GetCenterZ() + 0.5f * pLArTPC->GetWidthZ());
+    }
+
+    if (m_larTPCVector.empty())
+    {
+        std::cout << "LArRecoEventGenerator, no LArTPCs found in geometry file " << parameters.m_geometryFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_INITIALIZED);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SyntheticEventGenerator::GenerateEvent()
+{
+    m_nHitsU = 0;
+    m_nHitsV = 0;
+    m_nHitsW = 0;
+
+    if ((m_parameters.m_nTracks > 0) || (m_parameters.m_nShowers > 0))
+    {
+        const CartesianVector vertex(this->GetRandomVertex());
+
+        // A charged current interaction, with a leading muon followed by alternating protons and pions, and alternating electron and photon showers
+        const void *const pNeutrinoAddress(this->CreateMCParticle(nullptr, 14, 1001, vertex, vertex, 1.f));
+        std::exponential_distribution<float> trackLengthDistribution(1.f / m_parameters.m_meanTrackLength);
+
+        for (int iTrack = 0; iTrack < m_parameters.m_nTracks; ++iTrack)
+        {
+            const int particleId((0 == iTrack) ? 13 : (iTrack % 2) ? 2212 : 211);
+            const CartesianVector direction(this->GetRandomDirection());
+            const float length(std::min(trackLengthDistribution(m_randomEngine), this->GetDistanceToBoundary(vertex, direction)));
+            const CartesianVector endpoint(vertex + direction * length);
+
+            this->CreateHits(this->CreateMCParticle(pNeutrinoAddress, particleId, 0, vertex, endpoint, MIP_DEDX * length), vertex, endpoint);
+        }
+
+        std::exponential_distribution<float> conversionDistribution(1.f / 15.f);
+
+        for (int iShower = 0; iShower < m_parameters.m_nShowers; ++iShower)
+        {
+            const int particleId((iShower % 2) ? 22 : 11);
+            const CartesianVector direction(this->GetRandomDirection());
+            const float conversionDistance((22 == particleId) ? conversionDistribution(m_randomEngine) : 0.f);
+            const CartesianVector startPosition(vertex + direction * std::min(conversionDistance, this->GetDistanceToBoundary(vertex, direction)));
+
+            this->CreateShower(pNeutrinoAddress, particleId, startPosition, direction);
+        }
+    }
+
+    // Cosmic-ray muons enter through the top of the detector, with zenith angles up to 60 degrees
+    std::uniform_real_distribution<float> xDistribution(m_minX, m_maxX), zDistribution(m_minZ, m_maxZ);
+    std::uniform_real_distribution<float> cosThetaDistribution(0.5f, 1.f), phiDistribution(0.f, 2.f * M_PI);
+
+    for (int iCosmicRay = 0; iCosmicRay < m_parameters.m_nCosmicRays; ++iCosmicRay)
+    {
+        const CartesianVector startPosition(xDistribution(m_randomEngine), m_maxY, zDistribution(m_randomEngine));
+        const float cosTheta(cosThetaDistribution(m_randomEngine)), phi(phiDistribution(m_randomEngine));
+        const float sinTheta(std::sqrt(1.f - cosTheta * cosTheta));
+        const CartesianVector direction(sinTheta * std::cos(phi), -cosTheta, sinTheta * std::sin(phi));
+        const float length(this->GetDistanceToBoundary(startPosition, direction));
+        const CartesianVector endpoint(startPosition + direction * length);
+
+        this->CreateHits(this->CreateMCParticle(nullptr, 13, 0, startPosition, endpoint, MIP_DEDX * length), startPosition, endpoint);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const void *SyntheticEventGenerator::CreateMCParticle(const void *const pParentAddress, const int particleId, const int nuanceCode,
+    const CartesianVector &vertex, const CartesianVector &endpoint, const float energy)
+{
+    const void *const pAddress(this->GetNextAddress());
+    const CartesianVector displacement(endpoint - vertex);
+
+    lar_content::LArMCParticleParameters parameters;
+    parameters.m_nuanceCode = nuanceCode;
+    parameters.m_process = lar_content::MC_PROC_PRIMARY;
+    parameters.m_energy = energy;
+    parameters.m_momentum = (displacement.GetMagnitude() > std::numeric_limits<float>::epsilon()) ? displacement.GetUnitVector() * energy
+                                                                                                 : CartesianVector(0.f, 0.f, energy);
+    parameters.m_vertex = vertex;
+    parameters.m_endpoint = endpoint;
+    parameters.m_particleId = particleId;
+    parameters.m_mcParticleType = MC_3D;
+    parameters.m_pParentAddress = pAddress;
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::MCParticle::Create(m_pandora, parameters, m_mcParticleFactory));
+
+    if (pParentAddress)
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetMCParentDaughterRelationship(m_pandora, pParentAddress, pAddress));
+
+    return pAddress;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SyntheticEventGenerator::CreateShower(const void *const pParentAddress, const int particleId, const CartesianVector &startPosition,
+    const CartesianVector &direction)
+{
+    std::exponential_distribution<float> lengthDistribution(1.f / m_parameters.m_meanShowerLength);
+    const float length(std::min(lengthDistribution(m_randomEngine), this->GetDistanceToBoundary(startPosition, direction)));
+    const CartesianVector endpoint(startPosition + direction * length);
+    const void *const pAddress(this->CreateMCParticle(pParentAddress, particleId, 0, startPosition, endpoint, MIP_DEDX * length * N_SHOWER_BRANCHES));
+
+    // The trunk is followed by branches starting along the shower axis, spreading about it
+    const CartesianVector trunkEndpoint(startPosition + direction * (0.3f * length));
+    this->CreateHits(pAddress, startPosition, trunkEndpoint);
+
+    std::uniform_real_distribution<float> depthDistribution(0.f, 0.7f * length);
+    std::exponential_distribution<float> branchLengthDistribution(1.f / std::max(0.3f * length, 1.f));
+
+    for (int iBranch = 0; iBranch < N_SHOWER_BRANCHES; ++iBranch)
+    {
+        const CartesianVector branchStart(startPosition + direction * depthDistribution(m_randomEngine));
+        const CartesianVector branchDirection((direction + this->GetRandomDirection() * 0.3f).GetUnitVector());
+        const float branchLength(std::min(branchLengthDistribution(m_randomEngine), this->GetDistanceToBoundary(branchStart, branchDirection)));
+
+        this->CreateHits(pAddress, branchStart, branchStart + branchDirection * branchLength);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SyntheticEventGenerator::CreateHits(const void *const pMCParticleAddress, const CartesianVector &startPosition, const CartesianVector &endPosition)
+{
+    const CartesianVector displacement(endPosition - startPosition);
+    const LArTPC *const pReferenceLArTPC(m_larTPCVector.front());
+
+    for (const HitType hitType : {TPC_VIEW_U, TPC_VIEW_V, TPC_VIEW_W})
+    {
+        // ATTN Without a fixed number of hits, there is a hit for each wire crossed, or for each hit width travelled along the drift
+        const float deltaWire(std::fabs(this->GetWireCoordinate(pReferenceLArTPC, hitType, endPosition) -
+                                        this->GetWireCoordinate(pReferenceLArTPC, hitType, startPosition)));
+        const int nHits((m_parameters.m_nHitsPerView > 0)
+                ? m_parameters.m_nHitsPerView
+                : std::max(1, static_cast<int>(std::ceil(std::max(deltaWire / this->GetWirePitch(pReferenceLArTPC, hitType),
+                                                           std::fabs(displacement.GetX()) / HIT_WIDTH)))));
+        const float energy(MIP_DEDX * displacement.GetMagnitude() / nHits);
+
+        for (int iHit = 0; iHit < nHits; ++iHit)
+        {
+            const CartesianVector position(startPosition + displacement * ((iHit + 0.5f) / nHits));
+            const LArTPC *const pLArTPC(this->GetLArTPC(position));
+
+            if (pLArTPC)
+                this->CreateHit(pMCParticleAddress, pLArTPC, hitType, position, energy);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const LArTPC *SyntheticEventGenerator::GetLArTPC(const CartesianVector &position) const
+{
+    for (const LArTPC *const pLArTPC : m_larTPCVector)
+    {
+        if ((std::fabs(position.GetX() - pLArTPC->GetCenterX()) < 0.5f * pLArTPC->GetWidthX()) &&
+            (std::fabs(position.GetY() - pLArTPC->GetCenterY()) < 0.5f * pLArTPC->GetWidthY()) &&
+            (std::fabs(position.GetZ() - pLArTPC->GetCenterZ()) < 0.5f * pLArTPC->GetWidthZ()))
+        {
+            return pLArTPC;
+        }
+    }
+
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SyntheticEventGenerator::CreateHit(
+    const void *const pMCParticleAddress, const LArTPC *const pLArTPC, const HitType hitType, const CartesianVector &position, const float energy)
+{
+    // There are no hits on the missing or unresponsive wires, nor in the inactive drift regions, described by the detector gaps
+    const CartesianVector hitPosition(position.GetX(), 0.f, this->GetWireCoordinate(pLArTPC, hitType, position));
+
+    if (m_detectorGapIndex.IsInGap(hitPosition, hitType))
+        return;
+
+    const void *const pAddress(this->GetNextAddress());
+    const float wirePitch(this->GetWirePitch(pLArTPC, hitType));
+
+    lar_content::LArCaloHitParameters parameters;
+    parameters.m_positionVector = hitPosition;
+    parameters.m_expectedDirection = CartesianVector(0.f, 0.f, 1.f);
+    parameters.m_cellNormalVector = CartesianVector(0.f, 0.f, 1.f);
+    parameters.m_cellGeometry = RECTANGULAR;
+    parameters.m_cellSize0 = HIT_WIDTH;
+    parameters.m_cellSize1 = wirePitch;
+    parameters.m_cellThickness = wirePitch;
+    parameters.m_nCellRadiationLengths = 1.f;
+    parameters.m_nCellInteractionLengths = 1.f;
+    parameters.m_time = 0.f;
+    parameters.m_inputEnergy = energy;
+    parameters.m_mipEquivalentEnergy = energy / (MIP_DEDX * wirePitch);
+    parameters.m_electromagneticEnergy = energy;
+    parameters.m_hadronicEnergy = energy;
+    parameters.m_isDigital = false;
+    parameters.m_hitType = hitType;
+    parameters.m_hitRegion = SINGLE_REGION;
+    parameters.m_layer = 0;
+    parameters.m_isInOuterSamplingLayer = false;
+    parameters.m_pParentAddress = pAddress;
+    parameters.m_larTPCVolumeId = pLArTPC->GetLArTPCVolumeId();
+    parameters.m_daughterVolumeId = 0;
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::CaloHit::Create(m_pandora, parameters, m_caloHitFactory));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetCaloHitToMCParticleRelationship(m_pandora, pAddress, pMCParticleAddress, 1.f));
+
+    ++((TPC_VIEW_U == hitType) ? m_nHitsU : (TPC_VIEW_V == hitType) ? m_nHitsV : m_nHitsW);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float SyntheticEventGenerator::GetWireCoordinate(const LArTPC *const pLArTPC, const HitType hitType, const CartesianVector &position) const
+{
+    // As for the rotational transformation plugin, the wire coordinate is z cos(theta) - y sin(theta), for wire angle theta
+    const float wireAngle((TPC_VIEW_U == hitType) ? pLArTPC->GetWireAngleU()
+            : (TPC_VIEW_V == hitType)             ? pLArTPC->GetWireAngleV()
+                                                  : pLArTPC->GetWireAngleW());
+
+    return (position.GetZ() * std::cos(wireAngle) - position.GetY() * std::sin(wireAngle));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float SyntheticEventGenerator::GetWirePitch(const LArTPC *const pLArTPC, const HitType hitType) const
+{
+    return ((TPC_VIEW_U == hitType) ? pLArTPC->GetWirePitchU() : (TPC_VIEW_V == hitType) ? pLArTPC->GetWirePitchV() : pLArTPC->GetWirePitchW());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float SyntheticEventGenerator::GetDistanceToBoundary(const CartesianVector &position, const CartesianVector &direction) const
+{
+    float distance(std::numeric_limits<float>::max());
+
+    const float positionArray[3] = {position.GetX(), position.GetY(), position.GetZ()};
+    const float directionArray[3] = {direction.GetX(), direction.GetY(), direction.GetZ()};
+    const float minArray[3] = {m_minX, m_minY, m_minZ};
+    const float maxArray[3] = {m_maxX, m_maxY, m_maxZ};
+
+    for (unsigned int iAxis = 0; iAxis < 3; ++iAxis)
+    {
+        if (directionArray[iAxis] > std::numeric_limits<float>::epsilon())
+            distance = std::min(distance, (maxArray[iAxis] - positionArray[iAxis]) / directionArray[iAxis]);
+
+        if (directionArray[iAxis] < -std::numeric_limits<float>::epsilon())
+            distance = std::min(distance, (minArray[iAxis] - positionArray[iAxis]) / directionArray[iAxis]);
+    }
+
+    return std::max(distance, 0.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+CartesianVector SyntheticEventGenerator::GetRandomVertex()
+{
+    std::uniform_int_distribution<std::size_t> larTPCDistribution(0, m_larTPCVector.size() - 1);
+    const LArTPC *const pLArTPC(m_larTPCVector.at(larTPCDistribution(m_randomEngine)));
+
+    const float halfWidthX(std::max(0.5f * pLArTPC->GetWidthX() - VERTEX_MARGIN, 0.f));
+    const float halfWidthY(std::max(0.5f * pLArTPC->GetWidthY() - VERTEX_MARGIN, 0.f));
+    const float halfWidthZ(std::max(0.5f * pLArTPC->GetWidthZ() - VERTEX_MARGIN, 0.f));
+    std::uniform_real_distribution<float> unitDistribution(-1.f, 1.f);
+
+    return CartesianVector(pLArTPC->GetCenterX() + halfWidthX * unitDistribution(m_randomEngine),
+        pLArTPC->GetCenterY() + halfWidthY * unitDistribution(m_randomEngine), pLArTPC->GetCenterZ() + halfWidthZ * unitDistribution(m_randomEngine));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+CartesianVector SyntheticEventGenerator::GetRandomDirection()
+{
+    std::uniform_real_distribution<float> cosThetaDistribution(-1.f, 1.f), phiDistribution(0.f, 2.f * M_PI);
+    const float cosTheta(cosThetaDistribution(m_randomEngine)), phi(phiDistribution(m_randomEngine));
+    const float sinTheta(std::sqrt(1.f - cosTheta * cosTheta));
+
+    return CartesianVector(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const void *SyntheticEventGenerator::GetNextAddress()
+{
+    // ATTN Parent addresses need only be unique, for use as keys when creating objects and relationships
+    return reinterpret_cast<const void *>(++m_nAddresses);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void WriteEventWritingSettings(const GeneratorParameters &parameters, const std::string &settingsFileName)
+{
+    std::ofstream settingsFile(settingsFileName, std::ios::trunc);
+
+    if (!settingsFile.is_open())
+    {
+        std::cout << "LArRecoEventGenerator, unable to write settings file " << settingsFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    settingsFile << "<pandora>" << std::endl
+                 << "    <algorithm type = \"LArEventWriting\">" << std::endl
+                 << "        <EventFileName>" << parameters.m_outputFileName << "</EventFileName>" << std::endl
+                 << "        <ShouldWriteEvents>true</ShouldWriteEvents>" << std::endl
+                 << "        <ShouldOverwriteEventFile>true</ShouldOverwriteEventFile>" << std::endl
+                 << "        <ShouldWriteMCRelationships>true</ShouldWriteMCRelationships>" << std::endl
+                 << "        <ShouldWriteTrackRelationships>false</ShouldWriteTrackRelationships>" << std::endl
+                 << "        <UseLArCaloHits>true</UseLArCaloHits>" << std::endl
+                 << "        <UseLArMCParticles>true</UseLArMCParticles>" << std::endl
+                 << "    </algorithm>" << std::endl
+                 << "</pandora>" << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ParseCommandLine(int argc, char *argv[], GeneratorParameters &parameters)
+{
+    if (1 == argc)
+        return PrintOptions();
+
+    int c(0);
+
+    while ((c = getopt(argc, argv, "g:o:n:t:w:c:l:L:p:r:h")) != -1)
+    {
+        switch (c)
+        {
+            case 'g':
+                parameters.m_geometryFileName = optarg;
+                break;
+            case 'o':
+                parameters.m_outputFileName = optarg;
+                break;
+            case 'n':
+                parameters.m_nEvents = std::atoi(optarg);
+                break;
+            case 't':
+                parameters.m_nTracks = std::atoi(optarg);
+                break;
+            case 'w':
+                parameters.m_nShowers = std::atoi(optarg);
+                break;
+            case 'c':
+                parameters.m_nCosmicRays = std::atoi(optarg);
+                break;
+            case 'l':
+                parameters.m_meanTrackLength = std::atof(optarg);
+                break;
+            case 'L':
+                parameters.m_meanShowerLength = std::atof(optarg);
+                break;
+            case 'p':
+                parameters.m_nHitsPerView = std::atoi(optarg);
+                break;
+            case 'r':
+                parameters.m_seed = std::strtoul(optarg, nullptr, 10);
+                break;
+            case 'h':
+            default:
+                return PrintOptions();
+        }
+    }
+
+    if (parameters.m_geometryFileName.empty() || parameters.m_outputFileName.empty())
+    {
+        std::cout << "LArRecoEventGenerator, the geometry file and output file are required" << std::endl;
+        return PrintOptions();
+    }
+
+    if ((parameters.m_nEvents < 0) || (parameters.m_nTracks < 0) || (parameters.m_nShowers < 0) || (parameters.m_nCosmicRays < 0) ||
+        (parameters.m_nHitsPerView < 0) || (parameters.m_meanTrackLength <= 0.f) || (parameters.m_meanShowerLength <= 0.f))
+    {
+        std::cout << "LArRecoEventGenerator, particle counts, hit counts and lengths cannot be negative" << std::endl;
+        return PrintOptions();
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrintOptions()
+{
+    std::cout << std::endl
+              << "./bin/LArRecoEventGenerator " << std::endl
+              << "    -g GeometryFile        (required) [detector geometry description: xml]" << std::endl
+              << "    -o OutputFile          (required) [event file to write: pndr/xml]" << std::endl
+              << "    -n NEvents             (optional) [no. of events, default 10]" << std::endl
+              << "    -t NTracks             (optional) [no. of track-like particles per neutrino interaction, default 3]" << std::endl
+              << "    -w NShowers            (optional) [no. of shower-like particles per neutrino interaction, default 1]" << std::endl
+              << "    -c NCosmicRays         (optional) [no. of overlaid cosmic-ray muons per event, default 0]" << std::endl
+              << "    -l MeanTrackLength     (optional) [cm, default 100]" << std::endl
+              << "    -L MeanShowerLength    (optional) [cm, default 50]" << std::endl
+              << "    -p NHitsPerView        (optional) [hits per view for each particle segment, default one per wire crossed]" << std::endl
+              << "    -r Seed                (optional) [random number seed, default 12345]" << std::endl
+              << std::endl;
+
+    return false;
+}
+
+} // namespace lar_reco
@@ -0,0 +1,273 @@
+/**
+ *  @file   LArReco/benchmark/SyntheticEventGenerator.h
+ *
+ *  @brief  Header file for the synthetic event generator, writing events for a detector geometry description
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_SYNTHETIC_EVENT_GENERATOR_H
+#define LAR_RECO_SYNTHETIC_EVENT_GENERATOR_H 1
+
+#include "Pandora/PandoraInternal.h"
+
+#include "larpandoracontent/LArObjects/LArCaloHit.h"
+#include "larpandoracontent/LArObjects/LArMCParticle.h"
+
+#include "GeometryCache.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pandora
+{
+class LArTPC;
+class Pandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  GeneratorParameters class
+ */
+class GeneratorParameters
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    GeneratorParameters();
+
+    std::string     m_geometryFileName;         ///< The detector geometry description, xml
+    std::string     m_outputFileName;           ///< The output event file, pndr or xml
+    int             m_nEvents;                  ///< The number of events to generate
+    int             m_nTracks;                  ///< The number of track-like particles from each neutrino interaction
+    int             m_nShowers;                 ///< The number of shower-like particles from each neutrino interaction
+    int             m_nCosmicRays;              ///< The number of cosmic-ray muons overlaid on each event
+    float           m_meanTrackLength;          ///< The mean track length, cm
+    float           m_meanShowerLength;         ///< The mean shower length, cm
+    int             m_nHitsPerView;             ///< The number of hits per view for each particle segment, or zero for one per wire
+    unsigned int    m_seed;                     ///< The random number seed
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  SyntheticEventGenerator class, creating the calo hits and mc particles of a synthetic event in a pandora instance. Each event
+ *          has a neutrino interaction, with track-like and shower-like daughters from a common vertex, and an overlay of cosmic-ray
+ *          muons crossing the detector from above. Particles are straight-line segments, or a bundle of segments for a shower, with hits
+ *          placed at each wire crossed in each view, within the LArTPCs registered with the pandora instance and outside its detector
+ *          gaps.
+ */
+class SyntheticEventGenerator
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  pandora the pandora instance, with its LArTPCs already registered
+     *  @param  parameters the generator parameters
+     */
+    SyntheticEventGenerator(const pandora::Pandora &pandora, const GeneratorParameters &parameters);
+
+    /**
+     *  @brief  Create the calo hits and mc particles for a new event
+     */
+    void GenerateEvent();
+
+    /**
+     *  @brief  Get the number of hits in a view created for the most recent event
+     *
+     *  @param  hitType the view
+     *
+     *  @return the number of hits
+     */
+    unsigned int GetNHits(const pandora::HitType hitType) const;
+
+private:
+    typedef std::vector<const pandora::LArTPC *> LArTPCVector;
+
+    /**
+     *  @brief  Create an mc particle
+     *
+     *  @param  pParentAddress the address of the parent mc particle, or nullptr for a primary
+     *  @param  particleId the pdg code
+     *  @param  nuanceCode the nuance code
+     *  @param  vertex the vertex
+     *  @param  endpoint the endpoint
+     *  @param  energy the energy, GeV
+     *
+     *  @return the address of the mc particle
+     */
+    const void *CreateMCParticle(const void *const pParentAddress, const int particleId, const int nuanceCode, const pandora::CartesianVector &vertex,
+        const pandora::CartesianVector &endpoint, const float energy);
+
+    /**
+     *  @brief  Create a shower-like particle, as a trunk and a bundle of branching segments
+     *
+     *  @param  pParentAddress the address of the parent mc particle
+     *  @param  particleId the pdg code
+     *  @param  startPosition the start position
+     *  @param  direction the shower direction
+     */
+    void CreateShower(const void *const pParentAddress, const int particleId, const pandora::CartesianVector &startPosition,
+        const pandora::CartesianVector &direction);
+
+    /**
+     *  @brief  Create the hits in each view for a straight-line particle segment
+     *
+     *  @param  pMCParticleAddress the address of the mc particle responsible for the hits
+     *  @param  startPosition the start position
+     *  @param  endPosition the end position
+     */
+    void CreateHits(const void *const pMCParticleAddress, const pandora::CartesianVector &startPosition, const pandora::CartesianVector &endPosition);
+
+    /**
+     *  @brief  Get the lar tpc containing a position, the first in lar tpc map order
+     *
+     *  @param  position the position
+     *
+     *  @return the address of the lar tpc, or nullptr if the position is not within a lar tpc
+     */
+    const pandora::LArTPC *GetLArTPC(const pandora::CartesianVector &position) const;
+
+    /**
+     *  @brief  Create a single hit
+     *
+     *  @param  pMCParticleAddress the address of the mc particle responsible for the hit
+     *  @param  pLArTPC the address of the lar tpc containing the hit
+     *  @param  hitType the view
+     *  @param  position the three dimensional hit position
+     *  @param  energy the deposited energy, GeV
+     */
+    void CreateHit(const void *const pMCParticleAddress, const pandora::LArTPC *const pLArTPC, const pandora::HitType hitType,
+        const pandora::CartesianVector &position, const float energy);
+
+    /**
+     *  @brief  Get the wire coordinate of a position in a view
+     *
+     *  @param  pLArTPC the address of the lar tpc
+     *  @param  hitType the view
+     *  @param  position the position
+     *
+     *  @return the wire coordinate
+     */
+    float GetWireCoordinate(const pandora::LArTPC *const pLArTPC, const pandora::HitType hitType, const pandora::CartesianVector &position) const;
+
+    /**
+     *  @brief  Get the wire pitch in a view
+     *
+     *  @param  pLArTPC the address of the lar tpc
+     *  @param  hitType the view
+     *
+     *  @return the wire pitch
+     */
+    float GetWirePitch(const pandora::LArTPC *const pLArTPC, const pandora::HitType hitType) const;
+
+    /**
+     *  @brief  Get the distance along a direction from a position within the detector to the detector boundary
+     *
+     *  @param  position the position
+     *  @param  direction the unit direction
+     *
+     *  @return the distance
+     */
+    float GetDistanceToBoundary(const pandora::CartesianVector &position, const pandora::CartesianVector &direction) const;
+
+    /**
+     *  @brief  Get a random position within a randomly chosen lar tpc, away from its faces
+     *
+     *  @return the position
+     */
+    pandora::CartesianVector GetRandomVertex();
+
+    /**
+     *  @brief  Get a random, isotropic unit direction
+     *
+     *  @return the direction
+     */
+    pandora::CartesianVector GetRandomDirection();
+
+    /**
+     *  @brief  Get a new, unique parent address for a calo hit or mc particle
+     *
+     *  @return the address
+     */
+    const void *GetNextAddress();
+
+    const pandora::Pandora             &m_pandora;              ///< The pandora instance
+    const GeneratorParameters          &m_parameters;           ///< The generator parameters
+    LArTPCVector                        m_larTPCVector;         ///< The lar tpcs
+    DetectorGapIndex                    m_detectorGapIndex;     ///< The index used to find the hits in detector gaps
+    float                               m_minX;                 ///< The minimum x coordinate of the detector
+    float                               m_maxX;                 ///< The maximum x coordinate of the detector
+    float                               m_minY;                 ///< The minimum y coordinate of the detector
+    float                               m_maxY;                 ///< The maximum y coordinate of the detector
+    float                               m_minZ;                 ///< The minimum z coordinate of the detector
+    float                               m_maxZ;                 ///< The maximum z coordinate of the detector
+    std::mt19937                        m_randomEngine;         ///< The random number engine
+    std::uintptr_t                      m_nAddresses;           ///< The number of parent addresses issued
+    unsigned int                        m_nHitsU;               ///< The number of u hits created for the current event
+    unsigned int                        m_nHitsV;               ///< The number of v hits created for the current event
+    unsigned int                        m_nHitsW;               ///< The number of w hits created for the current event
+    lar_content::LArCaloHitFactory      m_caloHitFactory;       ///< The lar calo hit factory
+    lar_content::LArMCParticleFactory   m_mcParticleFactory;    ///< The lar mc particle factory
+};
+
+/**
+ *  @brief  Write the settings that configure a pandora instance to write each event to the output file
+ *
+ *  @param  parameters the generator parameters
+ *  @param  settingsFileName the settings file name
+ */
+void WriteEventWritingSettings(const GeneratorParameters &parameters, const std::string &settingsFileName);
+
+/**
+ *  @brief  Parse the command line arguments, setting the generator parameters
+ *
+ *  @param  argc argument count
+ *  @param  argv argument vector
+ *  @param  parameters to receive the generator parameters
+ *
+ *  @return success
+ */
+bool ParseCommandLine(int argc, char *argv[], GeneratorParameters &parameters);
+
+/**
+ *  @brief  Print the list of configurable options
+ *
+ *  @return false, to force abort
+ */
+bool PrintOptions();
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline GeneratorParameters::GeneratorParameters() :
+    m_geometryFileName(""),
+    m_outputFileName(""),
+    m_nEvents(10),
+    m_nTracks(3),
+    m_nShowers(1),
+    m_nCosmicRays(0),
+    m_meanTrackLength(100.f),
+    m_meanShowerLength(50.f),
+    m_nHitsPerView(0),
+    m_seed(12345)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int SyntheticEventGenerator::GetNHits(const pandora::HitType hitType) const
+{
+    return ((pandora::TPC_VIEW_U == hitType) ? m_nHitsU : (pandora::TPC_VIEW_V == hitType) ? m_nHitsV : m_nHitsW);
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_SYNTHETIC_EVENT_GENERATOR_H
@@ -0,0 +1,250 @@
+/**
+ *  @file   LArReco/include/AlgorithmTiming.h
+ *
+ *  @brief  Header file for the algorithm timing classes.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_ALGORITHM_TIMING_H
+#define LAR_RECO_ALGORITHM_TIMING_H 1
+
+#include "Pandora/Algorithm.h"
+
+#include "larpandoracontent/LArControlFlow/MasterAlgorithm.h"
+
+#include "PandoraInterface.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  TimingMarkerAlgorithm class. Markers are placed before each top-level algorithm, and at the end, of each settings file in an
+ *          instrumented settings snapshot. Each marker closes the timing of the preceding algorithm in its pandora instance and opens
+ *          the timing of the next.
+ */
+class TimingMarkerAlgorithm : public pandora::Algorithm
+{
+public:
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        pandora::Algorithm *CreateAlgorithm() const;
+    };
+
+    /**
+     *  @brief  Default constructor
+     */
+    TimingMarkerAlgorithm();
+
+private:
+    pandora::StatusCode Run();
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    std::string     m_instanceLabel;        ///< The label for the pandora instance, e.g. Master, CR, Nu or Slicing
+    std::string     m_nextAlgorithmType;    ///< The type of the algorithm that follows the marker, empty for the final marker
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  TimedMasterAlgorithm class, replacing the master algorithm in an instrumented settings snapshot so that the timing markers are
+ *          also registered with each of the daughter pandora instances
+ */
+class TimedMasterAlgorithm : public lar_content::MasterAlgorithm
+{
+public:
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        pandora::Algorithm *CreateAlgorithm() const;
+    };
+
+private:
+    pandora::StatusCode RegisterCustomContent(const pandora::Pandora *const pPandora) const;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  AlgorithmTimingRecorder class, collecting the wall time and call count of each top-level algorithm in each labelled pandora
+ *          instance, for every event, and writing a per-event breakdown (csv, or json if the file name ends in .json) and a job summary.
+ *          The time in the top-level LArDL algorithms is also reported as a total for each event. It includes the preparation of their
+ *          network inputs and the use of their outputs, so the network inference alone is measured by the InferenceTimingRecorder.
+ */
+class AlgorithmTimingRecorder : public EventObserver
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  outputFileName the name of the per-event output file, from which the summary file name is also derived
+     */
+    AlgorithmTimingRecorder(const std::string &outputFileName);
+
+    /**
+     *  @brief  Destructor, writing the job summary
+     */
+    ~AlgorithmTimingRecorder();
+
+    AlgorithmTimingRecorder(const AlgorithmTimingRecorder &) = delete;
+    AlgorithmTimingRecorder &operator=(const AlgorithmTimingRecorder &) = delete;
+
+    void EventProcessed(const EventId &eventId, const double readTime, const double processTime);
+
+    /**
+     *  @brief  Register the timing marker and timed master algorithms with a pandora instance
+     *
+     *  @param  pandora the pandora instance
+     *
+     *  @return success
+     */
+    static pandora::StatusCode RegisterAlgorithms(const pandora::Pandora &pandora);
+
+    /**
+     *  @brief  Record a timing marker, reached by the calling thread in the specified pandora instance
+     *
+     *  @param  pPandora the address of the pandora instance
+     *  @param  instanceLabel the label for the pandora instance
+     *  @param  nextAlgorithmType the type of the algorithm that follows the marker, empty for the final marker
+     */
+    static void RecordMarker(const pandora::Pandora *const pPandora, const std::string &instanceLabel, const std::string &nextAlgorithmType);
+
+private:
+    /**
+     *  @brief  AlgorithmTiming class
+     */
+    class AlgorithmTiming
+    {
+    public:
+        /**
+         *  @brief  Default constructor
+         */
+        AlgorithmTiming();
+
+        unsigned int    m_nCalls;       ///< The number of calls
+        double          m_time;         ///< The total wall time, in seconds
+    };
+
+    /**
+     *  @brief  OpenTiming class, describing an algorithm whose timing has been opened by a marker but not yet closed
+     */
+    class OpenTiming
+    {
+    public:
+        std::chrono::steady_clock::time_point   m_startTime;        ///< The time at which the timing was opened
+        std::string                             m_instanceLabel;    ///< The label for the pandora instance
+        std::string                             m_algorithmType;    ///< The algorithm type
+    };
+
+    typedef std::pair<std::string, std::string> TimingKey;             ///< The instance label and algorithm type
+    typedef std::map<TimingKey, AlgorithmTiming> AlgorithmTimingMap;
+    typedef std::map<const pandora::Pandora *, OpenTiming> OpenTimingMap;
+
+    /**
+     *  @brief  Get the algorithm timings accumulated by the calling thread since its last processed event
+     *
+     *  @return the algorithm timing map
+     */
+    static AlgorithmTimingMap &GetThreadTimingMap();
+
+    /**
+     *  @brief  Get the timings opened, but not yet closed, in each pandora instance by the calling thread
+     *
+     *  @return the open timing map
+     */
+    static OpenTimingMap &GetThreadOpenTimingMap();
+
+    /**
+     *  @brief  Write the job summary file and print the most expensive algorithms
+     */
+    void WriteSummary() const;
+
+    std::mutex          m_mutex;            ///< The mutex protecting the output file and job totals
+    const std::string   m_outputFileName;   ///< The name of the per-event output file
+    const bool          m_isJson;           ///< Whether to write json, rather than csv
+    std::ofstream       m_outputFile;       ///< The per-event output file
+    AlgorithmTimingMap  m_jobTimingMap;     ///< The algorithm timings accumulated over the job
+    unsigned int        m_nEvents;          ///< The number of events processed
+    double              m_totalReadTime;    ///< The total time spent reading events, in seconds
+    double              m_totalProcessTime; ///< The total time spent processing events, in seconds
+    double              m_totalDLTime;      ///< The total time spent in the top-level LArDL algorithms, in seconds
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  InferenceTimingRecorder class, measuring the time spent in LibTorch operators, which perform the network inference, during
+ *          each event, without instrumenting the settings. Only the outermost operator on each thread is timed, so nested operators are
+ *          not counted twice, and work on the LibTorch thread pools is covered by the operator awaiting it. Writes the per-event times,
+ *          csv, and prints a job total.
+ */
+class InferenceTimingRecorder : public EventObserver
+{
+public:
+    /**
+     *  @brief  Constructor, starting to observe LibTorch operators
+     *
+     *  @param  outputFileName the name of the per-event output file
+     */
+    InferenceTimingRecorder(const std::string &outputFileName);
+
+    /**
+     *  @brief  Destructor, ceasing to observe LibTorch operators and printing the job total
+     */
+    ~InferenceTimingRecorder();
+
+    InferenceTimingRecorder(const InferenceTimingRecorder &) = delete;
+    InferenceTimingRecorder &operator=(const InferenceTimingRecorder &) = delete;
+
+    void EventStarted(const EventId &eventId);
+    void EventProcessed(const EventId &eventId, const double readTime, const double processTime);
+
+private:
+    std::mutex          m_mutex;                ///< The mutex protecting the output file and job totals
+    const std::string   m_outputFileName;       ///< The name of the per-event output file
+    std::ofstream       m_outputFile;           ///< The per-event output file
+    std::uint64_t       m_callbackHandle;       ///< The handle of the LibTorch operator callback
+    unsigned int        m_nEvents;              ///< The number of events processed
+    double              m_totalProcessTime;     ///< The total time spent processing events, in seconds
+    double              m_totalInferenceTime;   ///< The total time spent in LibTorch operators, in seconds
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline pandora::Algorithm *TimingMarkerAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new TimingMarkerAlgorithm();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline pandora::Algorithm *TimedMasterAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new TimedMasterAlgorithm();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline AlgorithmTimingRecorder::AlgorithmTiming::AlgorithmTiming() :
+    m_nCalls(0),
+    m_time(0.)
+{
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_ALGORITHM_TIMING_H
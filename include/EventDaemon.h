@@ -0,0 +1,100 @@
+/**
+ *  @file   LArReco/include/EventDaemon.h
+ *
+ *  @brief  Header file for the event daemon class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_DAEMON_H
+#define LAR_RECO_EVENT_DAEMON_H 1
+
+#include "PandoraInterface.h"
+
+#include <mutex>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventDaemon class, keeping a set of configured pandora instances alive and processing the event files named in requests
+ *          received over a socket, so that repeated jobs do not pay the cost of creating and configuring the instances
+ *
+ *  Requests:   PROCESS <nEventsToSkip> <nEventsToProcess> <eventFileList>, SHUTDOWN
+ *  Replies:    EVENT <eventNumber> <readMilliseconds> <processMilliseconds> <fileName>, for each event as it completes, then
+ *              DONE <nEvents> <wallSeconds> or FAILED <nEvents> <wallSeconds> <reason>; BYE in response to SHUTDOWN
+ *
+ *  Clients are served one at a time, with the events of each request shared between all of the instances. Output files written by
+ *  the algorithms, such as validation trees, are not rotated per request: they hold the events of every request served, and are only
+ *  completed when the daemon shuts down and deletes its instances. Event file names are made absolute by the submitting client.
+ */
+class EventDaemon : public EventObserver
+{
+public:
+    /**
+     *  @brief  Constructor, starting to listen for clients
+     *
+     *  @param  parameters the application parameters
+     *  @param  primaryPandoraList the list of primary pandora instances, one per worker thread
+     */
+    EventDaemon(const Parameters &parameters, const PrimaryPandoraList &primaryPandoraList);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~EventDaemon();
+
+    EventDaemon(const EventDaemon &) = delete;
+    EventDaemon &operator=(const EventDaemon &) = delete;
+
+    /**
+     *  @brief  Serve clients until a shutdown request is received
+     */
+    void Run();
+
+    void EventProcessed(const EventId &eventId, const double readTime, const double processTime);
+
+    /**
+     *  @brief  Submit a request to a running daemon and print its replies, or ask it to shut down if the event file list is empty
+     *
+     *  @param  address the daemon address
+     *  @param  eventFileNameList the colon-separated list of event file names
+     *  @param  nEventsToSkip the number of events to skip in the first file
+     *  @param  nEventsToProcess the number of events to process (negative for all events)
+     *
+     *  @return whether the request was completed successfully
+     */
+    static bool SubmitRequest(const std::string &address, const std::string &eventFileNameList, const unsigned int nEventsToSkip,
+        const int nEventsToProcess);
+
+private:
+    /**
+     *  @brief  Serve requests from a connected client, until it disconnects or requests a shutdown
+     *
+     *  @param  socket the connected socket
+     *
+     *  @return whether to continue serving further clients
+     */
+    bool ServeClient(const int socket);
+
+    /**
+     *  @brief  Process the events named in a request, streaming the status of each event to the client
+     *
+     *  @param  socket the connected socket
+     *  @param  eventFileNameList the colon-separated list of event file names
+     *  @param  nEventsToSkip the number of events to skip in the first file
+     *  @param  nEventsToProcess the number of events to process (negative for all events)
+     */
+    void ProcessRequest(const int socket, const std::string &eventFileNameList, const unsigned int nEventsToSkip, const int nEventsToProcess);
+
+    const Parameters           &m_parameters;             ///< The application parameters
+    const PrimaryPandoraList   &m_primaryPandoraList;     ///< The list of primary pandora instances
+    int                         m_listenSocket;           ///< The listening socket
+
+    std::mutex                  m_mutex;                  ///< The mutex protecting the client socket and event count
+    int                         m_clientSocket;           ///< The socket of the client whose request is being processed
+    unsigned int                m_nEventsProcessed;       ///< The number of events processed for the current request
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_DAEMON_H
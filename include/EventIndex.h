@@ -0,0 +1,207 @@
+/**
+ *  @file   LArReco/include/EventIndex.h
+ *
+ *  @brief  Header file for the event index, a sidecar file recording the position and size of each event in a pndr file.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_INDEX_H
+#define LAR_RECO_EVENT_INDEX_H 1
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventIndex class, recording the byte offset and number of calo hits of each event in a pndr file
+ *
+ *  The index is kept alongside the event file, as <eventFileName>.index, and is only used while the size and modification time of the
+ *  event file match those recorded in the index. Format, one entry per line after the header:
+ *
+ *      # LArReco event index v1
+ *      <fileSize> <modificationTime> <nEvents>
+ *      <eventNumber> <byteOffset> <nHits>
+ */
+class EventIndex
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    EventIndex();
+
+    /**
+     *  @brief  Whether an event file can be indexed, i.e. whether it is a pndr file
+     *
+     *  @param  eventFileName the event file name
+     *
+     *  @return boolean
+     */
+    static bool IsIndexable(const std::string &eventFileName);
+
+    /**
+     *  @brief  Get the name of the index file for an event file
+     *
+     *  @param  eventFileName the event file name
+     *
+     *  @return the index file name
+     */
+    static std::string GetIndexFileName(const std::string &eventFileName);
+
+    /**
+     *  @brief  Read the index for an event file
+     *
+     *  @param  eventFileName the event file name
+     *
+     *  @return whether a current index was read, or false if the index is missing, malformed or older than the event file
+     */
+    bool Read(const std::string &eventFileName);
+
+    /**
+     *  @brief  Write the index for an event file, replacing any existing index
+     *
+     *  @param  eventFileName the event file name
+     *
+     *  @return success
+     */
+    bool Write(const std::string &eventFileName) const;
+
+    /**
+     *  @brief  Fill the byte offset of each event by walking the container headers of an event file, without reading the events. The
+     *          number of hits in each event is left at zero.
+     *
+     *  @param  eventFileName the event file name
+     *
+     *  @return success
+     */
+    bool Scan(const std::string &eventFileName);
+
+    /**
+     *  @brief  Get the number of events in the file
+     *
+     *  @return the number of events
+     */
+    unsigned int GetNEvents() const;
+
+    /**
+     *  @brief  Get the byte offset of the container holding an event
+     *
+     *  @param  eventNumber the event number
+     *
+     *  @return the byte offset
+     */
+    std::int64_t GetByteOffset(const unsigned int eventNumber) const;
+
+    /**
+     *  @brief  Set the number of calo hits in an event
+     *
+     *  @param  eventNumber the event number
+     *  @param  nHits the number of calo hits
+     */
+    void SetNHits(const unsigned int eventNumber, const unsigned int nHits);
+
+    /**
+     *  @brief  Read the header of the container at a position in an event file
+     *
+     *  @param  eventFile the event file stream
+     *  @param  containerPosition the byte offset of the container
+     *  @param  isEventContainer to receive whether the container holds an event
+     *  @param  containerSize to receive the size of the whole container, in bytes
+     *
+     *  @return whether a valid container header was read
+     */
+    static bool ReadContainerHeader(std::istream &eventFile, const std::int64_t containerPosition, bool &isEventContainer,
+        std::int64_t &containerSize);
+
+private:
+    /**
+     *  @brief  Get the size and modification time of an event file
+     *
+     *  @param  eventFileName the event file name
+     *  @param  fileSize to receive the file size, in bytes
+     *  @param  modificationTime to receive the modification time, in seconds since the epoch
+     *
+     *  @return success
+     */
+    static bool GetFileStatus(const std::string &eventFileName, std::int64_t &fileSize, std::int64_t &modificationTime);
+
+    /**
+     *  @brief  Entry class, describing a single event
+     */
+    class Entry
+    {
+    public:
+        std::int64_t    m_byteOffset;   ///< The byte offset of the container holding the event
+        unsigned int    m_nHits;        ///< The number of calo hits in the event
+    };
+
+    typedef std::vector<Entry> EntryList;
+
+    std::int64_t        m_fileSize;             ///< The size of the indexed event file, in bytes
+    std::int64_t        m_modificationTime;     ///< The modification time of the indexed event file, in seconds since the epoch
+    EntryList           m_entryList;            ///< The entry for each event, indexed by event number
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventIndexBuilder class, gathering the number of hits in each event read from a pndr file without a current index, and writing
+ *          the index once every event in the file has been read, by any thread
+ */
+class EventIndexBuilder
+{
+public:
+    /**
+     *  @brief  Record an event that has been read
+     *
+     *  @param  eventFileName the event file name
+     *  @param  eventNumber the event number
+     *  @param  nHits the number of calo hits in the event
+     */
+    static void EventRead(const std::string &eventFileName, const unsigned int eventNumber, const unsigned int nHits);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline EventIndex::EventIndex() :
+    m_fileSize(0),
+    m_modificationTime(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string EventIndex::GetIndexFileName(const std::string &eventFileName)
+{
+    return (eventFileName + ".index");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int EventIndex::GetNEvents() const
+{
+    return m_entryList.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::int64_t EventIndex::GetByteOffset(const unsigned int eventNumber) const
+{
+    return m_entryList.at(eventNumber).m_byteOffset;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void EventIndex::SetNHits(const unsigned int eventNumber, const unsigned int nHits)
+{
+    m_entryList.at(eventNumber).m_nHits = nHits;
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_INDEX_H
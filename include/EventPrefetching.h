@@ -0,0 +1,114 @@
+/**
+ *  @file   LArReco/include/EventPrefetching.h
+ *
+ *  @brief  Header file for the event prefetcher, reading events ahead of their reconstruction.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_PREFETCHING_H
+#define LAR_RECO_EVENT_PREFETCHING_H 1
+
+#include "EventReading.h"
+#include "PandoraInterface.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventPrefetcher class, reading events on a dedicated thread while earlier events are reconstructed
+ *
+ *  Each primary pandora instance acts as a staging buffer: the reading thread draws events from the queue and reads each into an idle
+ *  instance, which is then handed, with its event already in place, to the next consumer. The consumer processes and resets the instance
+ *  before releasing it to be refilled. With one consumer and two instances, one event is read while the other is reconstructed.
+ */
+class EventPrefetcher
+{
+public:
+    /**
+     *  @brief  Constructor, starting the reading thread
+     *
+     *  @param  primaryPandoraList the list of primary pandora instances, each of which will receive events
+     *  @param  eventReadingSettings the event reading settings
+     *  @param  eventQueue the event queue
+     */
+    EventPrefetcher(const PrimaryPandoraList &primaryPandoraList, const EventReadingSettings &eventReadingSettings, EventQueue &eventQueue);
+
+    /**
+     *  @brief  Destructor, stopping the reading thread and discarding any events that have been read but not handed out
+     */
+    ~EventPrefetcher();
+
+    EventPrefetcher(const EventPrefetcher &) = delete;
+    EventPrefetcher &operator=(const EventPrefetcher &) = delete;
+
+    /**
+     *  @brief  Get the next event that has been read, waiting for the reading thread if necessary
+     *
+     *  @param  pPrimaryPandora to receive the address of the primary pandora instance holding the event
+     *  @param  eventId to receive the event id
+     *
+     *  @return whether an event was available
+     */
+    bool GetNextEvent(const pandora::Pandora *&pPrimaryPandora, EventId &eventId);
+
+    /**
+     *  @brief  Return a primary pandora instance, which must have been reset, so that the next event can be read into it, reporting the
+     *          event that it held to the event queue as processed
+     *
+     *  @param  pPrimaryPandora the address of the primary pandora instance
+     *  @param  eventId the id of the processed event
+     */
+    void ReleaseEvent(const pandora::Pandora *const pPrimaryPandora, const EventId &eventId);
+
+    /**
+     *  @brief  Stop reading events, e.g. following a failure in one of the consumers
+     */
+    void Abort();
+
+private:
+    /**
+     *  @brief  Read events into idle instances until the queue is exhausted or reading is aborted
+     */
+    void ReadEvents();
+
+    /**
+     *  @brief  StagedEvent class, an event that has been read into a primary pandora instance
+     */
+    class StagedEvent
+    {
+    public:
+        const pandora::Pandora *m_pPrimaryPandora;    ///< The address of the primary pandora instance holding the event
+        EventId                 m_eventId;            ///< The event id
+    };
+
+    typedef std::deque<const pandora::Pandora *> PandoraQueue;
+    typedef std::deque<StagedEvent> StagedEventQueue;
+    typedef std::map<const pandora::Pandora *, std::unique_ptr<EventReader>> EventReaderMap;
+
+    EventQueue                 &m_eventQueue;             ///< The event queue
+    EventReaderMap              m_eventReaderMap;         ///< The event reader for each primary pandora instance
+
+    std::mutex                  m_mutex;                  ///< The mutex protecting the idle instances, staged events and status
+    std::condition_variable     m_conditionVariable;      ///< The condition variable signalling changes to the idle instances or staged events
+    PandoraQueue                m_idleQueue;              ///< The primary pandora instances awaiting an event
+    StagedEventQueue            m_stagedEventQueue;       ///< The events that have been read, in queue order
+    bool                        m_isReadingComplete;      ///< Whether the reading thread has read its final event
+    bool                        m_isAborted;              ///< Whether reading has been aborted
+    std::exception_ptr          m_pReadingException;      ///< The exception raised by the reading thread, if any
+
+    std::thread                 m_readingThread;          ///< The reading thread
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_PREFETCHING_H
@@ -0,0 +1,366 @@
+/**
+ *  @file   LArReco/include/EventReading.h
+ *
+ *  @brief  Header file for the event queue and event reader, used when the application drives event reading itself.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_READING_H
+#define LAR_RECO_EVENT_READING_H 1
+
+#include "Pandora/PandoraInternal.h"
+
+#include "EventIndex.h"
+
+#include <mutex>
+
+namespace pandora
+{
+class FileReader;
+class Pandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventId class, identifying an event by its file name and its position within that file
+ */
+class EventId
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    EventId();
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName the event file name
+     *  @param  eventNumber the event number within the file
+     */
+    EventId(const std::string &fileName, const unsigned int eventNumber);
+
+    std::string  m_fileName;    ///< The event file name
+    unsigned int m_eventNumber; ///< The event number within the file
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventReadingSettings class, mirroring the object factory configuration of the LArEventReading algorithm
+ */
+class EventReadingSettings
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    EventReadingSettings();
+
+    bool         m_useLArCaloHits;         ///< Whether to read lar calo hits, or standard pandora calo hits
+    unsigned int m_larCaloHitVersion;      ///< The lar calo hit version
+    bool         m_useLArMCParticles;      ///< Whether to read lar mc particles, or standard pandora mc particles
+    unsigned int m_larMCParticleVersion;   ///< The lar mc particle version
+};
+
+/**
+ *  @brief  Read the LArEventReading configuration from the top-level block of a pandora settings file
+ *
+ *  @param  settingsFile the path to the pandora settings file
+ *  @param  eventReadingSettings to receive the event reading settings
+ */
+void ReadEventReadingSettings(const std::string &settingsFile, EventReadingSettings &eventReadingSettings);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventQueue class, interface through which concurrent consumers draw the events to be processed
+ */
+class EventQueue
+{
+public:
+    /**
+     *  @brief  Destructor
+     */
+    virtual ~EventQueue() = default;
+
+    /**
+     *  @brief  Get the next event to be processed
+     *
+     *  @param  eventId to receive the event id
+     *
+     *  @return whether an event was available
+     */
+    virtual bool GetNextEvent(EventId &eventId) = 0;
+
+    /**
+     *  @brief  Report that an issued event could not be read, because it lies beyond the end of its file
+     *
+     *  @param  eventId the event id
+     */
+    virtual void SetEndOfFile(const EventId &eventId) = 0;
+
+    /**
+     *  @brief  Report that an issued event has been processed
+     *
+     *  @param  eventId the event id
+     */
+    virtual void SetEventProcessed(const EventId &eventId);
+
+    /**
+     *  @brief  Stop issuing events, e.g. following a failure in one of the consumers
+     */
+    virtual void Abort() = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  FileListEventQueue class, handing out events from a colon-separated event file list
+ *
+ *  The number of events in each file is taken from its event index, if current, and is otherwise not known in advance: events are
+ *  issued in order and consumers report back, via SetEndOfFile, any requested event that is found to lie beyond the end of its file.
+ */
+class FileListEventQueue : public EventQueue
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  eventFileNameList the colon-separated list of event file names
+     *  @param  nEventsToSkip the number of events to skip, continuing into subsequent files while the number of events in each is indexed
+     *  @param  nEventsToProcess the number of events to process (negative for all events)
+     */
+    FileListEventQueue(const std::string &eventFileNameList, const unsigned int nEventsToSkip, const int nEventsToProcess);
+
+    bool GetNextEvent(EventId &eventId);
+    void SetEndOfFile(const EventId &eventId);
+    void Abort();
+
+    /**
+     *  @brief  Get the next range of consecutive events to be processed, all drawn from a single file
+     *
+     *  @param  maxNEvents the maximum number of events in the range
+     *  @param  firstEventId to receive the id of the first event in the range
+     *  @param  nEvents to receive the number of events in the range
+     *
+     *  @return whether any events were available
+     */
+    bool GetNextEventRange(const unsigned int maxNEvents, EventId &firstEventId, unsigned int &nEvents);
+
+    /**
+     *  @brief  Report that an issued event could not be read, because it lies beyond the end of its file, along with a number of
+     *          subsequent issued events that are therefore also unavailable
+     *
+     *  @param  eventId the event id
+     *  @param  nUnavailableEvents the total number of issued events found to be unavailable, including the specified event
+     */
+    void SetEndOfFile(const EventId &eventId, const unsigned int nUnavailableEvents);
+
+    /**
+     *  @brief  Whether the queue will issue no further events
+     *
+     *  @return boolean
+     */
+    bool IsExhausted();
+
+private:
+    /**
+     *  @brief  Move past any files whose end has been reached, returning whether further events may be issued. Mutex must be held.
+     *
+     *  @return whether further events may be issued
+     */
+    bool AdvanceFile();
+
+    typedef std::vector<unsigned int> EventNumberList;
+
+    std::mutex            m_mutex;               ///< The mutex protecting the queue state
+    pandora::StringVector m_fileNameVector;      ///< The event file names, in processing order
+    EventNumberList       m_endOfFileList;       ///< The (first unavailable) event number at which each file ends, if known
+    unsigned int          m_fileIndex;           ///< The index of the file from which events are currently issued
+    unsigned int          m_nextEventNumber;     ///< The next event number to issue from the current file
+    int                   m_nEventsRemaining;    ///< The number of events still to be issued (negative for all events)
+    bool                  m_isAborted;           ///< Whether the queue has been aborted
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventListQueue class, handing out an explicit list of events, e.g. those flagged by validation
+ *
+ *  Each line of the event list names an event either as written to the Validation.C event file, "... fileId: <id>, eventNumber: <n>, ...",
+ *  or as "<file> <n>", where the file is given by name or by identifier. In the "<file> <n>" form, a file identifier is the position,
+ *  counting from zero, of the file in the event file list, and the event number counts the events in that file. In the Validation.C form,
+ *  the file identifier is the FileIdentifier of the validated job and the event number counts the events processed by that job, so the
+ *  event file list and number of events to skip must be those of the job. Such events are located by counting through the event file list,
+ *  which must be indexed for every file but the last, and lines from more than one job are rejected. Events are issued grouped by file, in
+ *  the order of the event file list, and in increasing event number within each file, so that the event readers only ever move forwards
+ *  through a file.
+ */
+class EventListQueue : public EventQueue
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  eventListFileName the name of the file listing the events
+     *  @param  eventFileNameList the colon-separated list of event file names, against which file identifiers are resolved
+     *  @param  nEventsToSkip the number of events skipped by the job whose validation event numbers are listed
+     *  @param  nEventsToProcess the maximum number of listed events to process (negative for all events)
+     */
+    EventListQueue(const std::string &eventListFileName, const std::string &eventFileNameList, const unsigned int nEventsToSkip,
+        const int nEventsToProcess);
+
+    bool GetNextEvent(EventId &eventId);
+    void SetEndOfFile(const EventId &eventId);
+    void Abort();
+
+private:
+    typedef std::vector<unsigned int> EventNumberList;
+
+    /**
+     *  @brief  Locate an event numbered as by the validation, i.e. by its position amongst the events processed by the validated job
+     *
+     *  @param  fileNameVector the event file names of the validated job
+     *  @param  endOfFileList the (first unavailable) event number at which each file ends, if known
+     *  @param  nEventsToSkip the number of events skipped by the validated job
+     *  @param  processedEventNumber the position of the event amongst those processed by the validated job
+     *  @param  eventId to receive the event id
+     *
+     *  @return whether the event could be located
+     */
+    static bool GetValidationEventId(const pandora::StringVector &fileNameVector, const EventNumberList &endOfFileList,
+        const unsigned int nEventsToSkip, const unsigned int processedEventNumber, EventId &eventId);
+
+    typedef std::vector<EventId> EventIdList;
+
+    std::mutex            m_mutex;               ///< The mutex protecting the queue state
+    EventIdList           m_eventIdList;         ///< The events to be issued, in processing order
+    unsigned int          m_nextEventIndex;      ///< The index of the next event to be issued
+    bool                  m_isAborted;           ///< Whether the queue has been aborted
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventReader class, reading identified events from pndr or xml files into a pandora instance. Events beyond the end of an
+ *          indexed file are rejected without reading, and the hits in each event read from an unindexed pndr file are counted, so that
+ *          its index can be written once every event has been read.
+ *
+ *  The pandora file reader can only reach an event other than the next by walking the containers from the start of the file. For an
+ *  indexed file, the requested event and any that follow it in a window are instead copied, from their indexed byte offsets, into a
+ *  temporary window file, which is read in place of the event file. The window holds just the requested event after a jump, and doubles
+ *  in size each time it is exhausted by events requested in order.
+ */
+class EventReader
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  pandora the pandora instance into which events will be read
+     *  @param  eventReadingSettings the event reading settings
+     */
+    EventReader(const pandora::Pandora &pandora, const EventReadingSettings &eventReadingSettings);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~EventReader();
+
+    EventReader(const EventReader &) = delete;
+    EventReader &operator=(const EventReader &) = delete;
+
+    /**
+     *  @brief  Read the specified event into the pandora instance
+     *
+     *  @param  eventId the event id
+     *
+     *  @return success, or failure if the event does not exist
+     */
+    pandora::StatusCode ReadEvent(const EventId &eventId);
+
+private:
+    /**
+     *  @brief  Replace the current file reader with one for the specified file
+     *
+     *  @param  fileName the event file name
+     */
+    void ReplaceFileReader(const std::string &fileName);
+
+    /**
+     *  @brief  Replace the current file reader with one for a window of events copied from the current, indexed, event file
+     *
+     *  @param  firstEventNumber the number of the first event in the window
+     *
+     *  @return success
+     */
+    bool ReplaceWithEventWindow(const unsigned int firstEventNumber);
+
+    /**
+     *  @brief  Create a file reader, configured with the event reading settings, for a pndr or xml file
+     *
+     *  @param  fileName the file name
+     *
+     *  @return the address of the file reader
+     */
+    pandora::FileReader *CreateFileReader(const std::string &fileName);
+
+    static const unsigned int   MAX_N_WINDOW_EVENTS = 64;           ///< The maximum number of events in a window
+    static const std::int64_t   MAX_WINDOW_SIZE = 64 * 1024 * 1024; ///< The size, in bytes, beyond which no further events are added to a window
+
+    const pandora::Pandora     &m_pandora;                ///< The pandora instance into which events are read
+    const EventReadingSettings  m_eventReadingSettings;   ///< The event reading settings
+    pandora::FileReader        *m_pFileReader;            ///< The current file reader
+    std::string                 m_fileName;               ///< The name of the file opened by the current file reader
+    unsigned int                m_nextEventNumber;        ///< The event number at which the current file reader is positioned
+    unsigned int                m_endEventNumber;         ///< The event number at which the events available to the current file reader end
+    unsigned int                m_nWindowEvents;          ///< The number of events in the latest window
+    EventIndex                  m_eventIndex;             ///< The event index of the current file, if current
+    bool                        m_isIndexed;              ///< Whether the current file has a current event index
+    bool                        m_shouldBuildIndex;       ///< Whether to report the events read from the current file to the index builder
+    unsigned int                m_nHits;                  ///< The number of calo hits created by the current file reader for the latest event
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline EventId::EventId() :
+    m_fileName(""),
+    m_eventNumber(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline EventId::EventId(const std::string &fileName, const unsigned int eventNumber) :
+    m_fileName(fileName),
+    m_eventNumber(eventNumber)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void EventQueue::SetEventProcessed(const EventId &)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline EventReadingSettings::EventReadingSettings() :
+    m_useLArCaloHits(true),
+    m_larCaloHitVersion(1),
+    m_useLArMCParticles(true),
+    m_larMCParticleVersion(1)
+{
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_READING_H
@@ -0,0 +1,174 @@
+/**
+ *  @file   LArReco/include/GeometryCache.h
+ *
+ *  @brief  Header file for the geometry cache, a binary copy of an xml geometry description, and the detector gap index.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_GEOMETRY_CACHE_H
+#define LAR_RECO_GEOMETRY_CACHE_H 1
+
+#include "Pandora/PandoraInternal.h"
+
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  GeometryCache class, converting an xml geometry description into a pndr file once, so that each pandora instance reads the
+ *          binary geometry rather than parsing the xml. The cache is kept alongside the xml, as <geometryFileName>.pndr, and carries
+ *          the modification time of the xml from which it was written, so that a stale cache is detected and rewritten.
+ */
+class GeometryCache
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  geometryFileName the geometry file name
+     */
+    GeometryCache(const std::string &geometryFileName);
+
+    /**
+     *  @brief  Get the geometry file to be read by pandora, writing the cache if it is missing or stale
+     *
+     *  @return the path to the cache, or to the original geometry file if it is not xml or the cache could not be written
+     */
+    std::string GetGeometryFileName() const;
+
+    /**
+     *  @brief  Get the name of the cache file for an xml geometry file
+     *
+     *  @param  geometryFileName the geometry file name
+     *
+     *  @return the cache file name
+     */
+    static std::string GetCacheFileName(const std::string &geometryFileName);
+
+private:
+    /**
+     *  @brief  Whether the cache exists and was written from the current version of the xml
+     *
+     *  @return boolean
+     */
+    bool IsUpToDate() const;
+
+    /**
+     *  @brief  Read the xml into a standalone pandora instance and write its geometry to the cache, replacing any existing cache
+     *
+     *  @return success
+     */
+    bool Write() const;
+
+    const std::string   m_geometryFileName;     ///< The geometry file name
+    const bool          m_isXml;                ///< Whether the geometry file is xml, and so can be cached
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  DetectorGapIndex class, answering whether a position is in a detector gap without iterating over every gap
+ *
+ *  Each line gap occupies a rectangle in x and z, widened by the gap tolerance. For each view, and for 3D, the distinct rectangle edges
+ *  divide the x-z plane into a grid of cells, each listing the gaps that overlap it. A lookup is a binary search along each axis, with
+ *  most cells empty, followed by the gap's own in-gap test for the few gaps in one cell, so the result is the same as that of iterating
+ *  over every gap. A view lists its own wire gaps and all drift gaps; 3D lists the drift gaps. Wire gaps in 3D, and any gaps other than
+ *  line gaps, are tested directly.
+ */
+class DetectorGapIndex
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  detectorGapList the detector gap list
+     *  @param  gapTolerance the tolerance with which to test each gap
+     */
+    DetectorGapIndex(const pandora::DetectorGapList &detectorGapList, const float gapTolerance);
+
+    /**
+     *  @brief  Whether a position is in a detector gap
+     *
+     *  @param  position the position, two dimensional for a view
+     *  @param  hitType the view, or 3D
+     *
+     *  @return boolean
+     */
+    bool IsInGap(const pandora::CartesianVector &position, const pandora::HitType hitType) const;
+
+private:
+    typedef std::vector<const pandora::DetectorGap *> DetectorGapVector;
+
+    /**
+     *  @brief  GapExtent class, the rectangle in x and z outside which a gap cannot contain a position
+     */
+    class GapExtent
+    {
+    public:
+        const pandora::DetectorGap *m_pDetectorGap;     ///< The address of the detector gap
+        float                       m_minX;             ///< The minimum x coordinate
+        float                       m_maxX;             ///< The maximum x coordinate
+        float                       m_minZ;             ///< The minimum z coordinate
+        float                       m_maxZ;             ///< The maximum z coordinate
+    };
+
+    typedef std::vector<GapExtent> GapExtentList;
+
+    /**
+     *  @brief  GapGrid class, the grid of cells, in x and z, for a single view
+     */
+    class GapGrid
+    {
+    public:
+        /**
+         *  @brief  Constructor
+         *
+         *  @param  gapExtentList the extents of the gaps to be placed in the grid
+         *  @param  directGapVector the gaps to be tested directly, for every position
+         */
+        GapGrid(const GapExtentList &gapExtentList, const DetectorGapVector &directGapVector);
+
+        /**
+         *  @brief  Whether a position is in one of the gaps of the grid
+         *
+         *  @param  position the position
+         *  @param  hitType the view, or 3D
+         *  @param  gapTolerance the tolerance with which to test each gap
+         *
+         *  @return boolean
+         */
+        bool IsInGap(const pandora::CartesianVector &position, const pandora::HitType hitType, const float gapTolerance) const;
+
+    private:
+        typedef std::vector<float> BoundaryList;
+        typedef std::vector<unsigned int> OffsetList;
+
+        BoundaryList        m_boundaryListX;        ///< The sorted boundaries of the grid intervals along x
+        BoundaryList        m_boundaryListZ;        ///< The sorted boundaries of the grid intervals along z
+        OffsetList          m_cellOffsetList;       ///< The position in the cell gap list of the first gap in each cell, and the end
+        DetectorGapVector   m_cellGapList;          ///< The gaps overlapping each cell, cell by cell
+        DetectorGapVector   m_directGapVector;      ///< The gaps tested directly, for every position
+    };
+
+    typedef std::vector<GapGrid> GapGridList;
+
+    const float         m_gapTolerance;     ///< The tolerance with which to test each gap
+    GapGridList         m_gapGridList;      ///< The grid for each of the u, v and w views, and for 3D
+    DetectorGapVector   m_allGapVector;     ///< All gaps, tested directly for any other hit type
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string GeometryCache::GetCacheFileName(const std::string &geometryFileName)
+{
+    return (geometryFileName + ".pndr");
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_GEOMETRY_CACHE_H
@@ -0,0 +1,137 @@
+/**
+ *  @file   LArReco/include/MemoryMonitor.h
+ *
+ *  @brief  Header file for the memory monitor class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_MEMORY_MONITOR_H
+#define LAR_RECO_MEMORY_MONITOR_H 1
+
+#include "PandoraInterface.h"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  MemoryMonitor class, recording for each event the peak resident memory of the process and, if built with ALLOCATION_COUNTING,
+ *          the number and size of the heap allocations made by the thread processing the event, between the start of event processing and
+ *          the end of the reset of the pandora instances. Writes a per-event csv file and a job summary of percentiles.
+ *
+ *          Allocations are counted by a replacement global operator new, so include all allocations made through new by pandora and its
+ *          content, but not direct calls to malloc. The peak resident memory is the process high-water mark, which is reset at the start
+ *          of an event only if no other event is in progress; with more than one thread it may therefore include concurrently processed
+ *          events.
+ */
+class MemoryMonitor : public EventObserver
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  outputFileName the name of the per-event output file, from which the summary file name is also derived
+     */
+    MemoryMonitor(const std::string &outputFileName);
+
+    /**
+     *  @brief  Destructor, writing the job summary
+     */
+    ~MemoryMonitor();
+
+    MemoryMonitor(const MemoryMonitor &) = delete;
+    MemoryMonitor &operator=(const MemoryMonitor &) = delete;
+
+    void EventStarted(const EventId &eventId);
+    void EventProcessed(const EventId &eventId, const double readTime, const double processTime);
+
+private:
+    /**
+     *  @brief  EventMemory class
+     */
+    class EventMemory
+    {
+    public:
+        std::string             m_fileName;         ///< The event file name
+        unsigned int            m_eventNumber;      ///< The event number within the file
+        long long               m_peakRssKB;        ///< The peak resident memory, in kB
+        unsigned long long      m_nAllocations;     ///< The number of allocations
+        unsigned long long      m_allocatedBytes;   ///< The total size of the allocations, in bytes
+    };
+
+    typedef std::vector<EventMemory> EventMemoryList;
+
+    /**
+     *  @brief  Reset the process resident memory high-water mark
+     *
+     *  @return success
+     */
+    static bool ResetPeakRss();
+
+    /**
+     *  @brief  Get the process resident memory high-water mark
+     *
+     *  @return the high-water mark, in kB, or -1 if unavailable
+     */
+    static long long GetPeakRss();
+
+    /**
+     *  @brief  Write the job summary file and print the percentiles and the events with the largest peak resident memory
+     */
+    void WriteSummary() const;
+
+    std::mutex          m_mutex;                ///< The mutex protecting the output file, event list and events in progress
+    const std::string   m_outputFileName;       ///< The name of the per-event output file
+    std::ofstream       m_outputFile;           ///< The per-event output file
+    EventMemoryList     m_eventMemoryList;      ///< The memory usage of each processed event
+    unsigned int        m_nEventsInProgress;    ///< The number of events currently being processed
+    bool                m_canResetPeakRss;      ///< Whether the process resident memory high-water mark can be reset
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventMemoryReleaser class, returning the heap memory freed by event resets to the operating system in one step, rather than
+ *          leaving it to fragment the heap over a long job. As the release locks every heap arena, it is made only after an event that
+ *          ends with the resident memory above a threshold, or once a number of events have been processed since the last release, and
+ *          by one thread at a time. Large allocations may also be given a fixed mmap threshold, so that the large per-event buffers are
+ *          mapped and unmapped individually instead of being carved from, and held in, the heap arenas.
+ */
+class EventMemoryReleaser : public EventObserver
+{
+public:
+    /**
+     *  @brief  Constructor, configuring the allocator
+     *
+     *  @param  rssThresholdMB the resident memory, in MB, above which memory is released after an event (0 for no threshold)
+     *  @param  nEventsPerRelease the number of events after which memory is released in any case (0 for never)
+     *  @param  mmapThresholdKB the fixed allocator mmap threshold, in kB (0 to keep the dynamic threshold)
+     */
+    EventMemoryReleaser(const unsigned int rssThresholdMB, const unsigned int nEventsPerRelease, const unsigned int mmapThresholdKB);
+
+    EventMemoryReleaser(const EventMemoryReleaser &) = delete;
+    EventMemoryReleaser &operator=(const EventMemoryReleaser &) = delete;
+
+    void EventProcessed(const EventId &eventId, const double readTime, const double processTime);
+
+private:
+    /**
+     *  @brief  Get the current resident memory of the process
+     *
+     *  @return the resident memory, in kB, or -1 if unavailable
+     */
+    static long long GetRss();
+
+    const long long             m_rssThresholdKB;       ///< The resident memory, in kB, above which memory is released (0 for no threshold)
+    const unsigned int          m_nEventsPerRelease;    ///< The number of events after which memory is released in any case (0 for never)
+    std::atomic<unsigned int>   m_nEventsSinceRelease;  ///< The number of events processed since the last release
+    std::mutex                  m_mutex;                ///< The mutex held while memory is released
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_MEMORY_MONITOR_H
@@ -10,6 +10,8 @@
 
 #include "Pandora/PandoraInputTypes.h"
 
+#include <vector>
+
 namespace pandora
 {
 class Pandora;
@@ -20,6 +22,13 @@ class Pandora;
 namespace lar_reco
 {
 
+class EventId;
+class EventPrefetcher;
+class EventQueue;
+class EventReadingSettings;
+
+typedef std::vector<const pandora::Pandora *> PrimaryPandoraList;
+
 /**
  *  @brief  Parameters class
  */
@@ -33,10 +42,33 @@ public:
 
     std::string m_settingsFile;      ///< The path to the pandora settings file (mandatory parameter)
     std::string m_eventFileNameList; ///< Colon-separated list of file names to be processed
+    std::string m_eventListFileName; ///< The file listing the (file, event number) pairs to be processed, if only selected events are wanted
     std::string m_geometryFileName;  ///< Name of the file containing geometry information
 
     int m_nEventsToProcess;          ///< The number of events to process (default all events in file)
     bool m_shouldDisplayEventNumber; ///< Whether event numbers should be displayed (default false)
+    int m_nThreads;                  ///< The number of event-parallel worker threads, each with its own pandora instances (default 1)
+    int m_nEventsToPrefetch;         ///< The number of events to read ahead of reconstruction, each into its own pandora instances (default 0)
+    int m_nTorchThreads;             ///< The number of LibTorch intra-op threads, used by each inference call (default 0, LibTorch default)
+    int m_nTorchInteropThreads;      ///< The number of LibTorch inter-op threads, shared by the process (default 0, LibTorch default)
+
+    std::string m_coordinatorAddress; ///< The address on which to coordinate worker processes, unix:<path> or <host>:<port>
+    std::string m_workerAddress;      ///< The address of the coordinator from which to request work, unix:<path> or <host>:<port>
+    int m_nLocalWorkers;              ///< The number of worker processes to be started by the coordinator (default 0)
+    int m_nEventsPerWorkUnit;         ///< The maximum number of events in each work unit issued by the coordinator (default 10)
+    std::string m_outputFileNameList; ///< Colon-separated list of output files to gather from workers and merge
+
+    std::string m_daemonAddress;       ///< The address on which to serve event processing requests, keeping pandora instances alive
+    std::string m_daemonClientAddress; ///< The address of a running daemon, to which to submit the event file list
+
+    std::string m_timingFileName;      ///< The file to receive per-event algorithm timings, csv or json (default no timing)
+    std::string m_memoryFileName;      ///< The file to receive per-event peak memory and allocation counts, csv (default no accounting)
+    std::string m_inferenceFileName;   ///< The file to receive per-event LibTorch operator times, csv (default no inference timing)
+    bool m_shouldReleaseEventMemory;   ///< Whether to return the heap memory freed by event resets to the system (default false)
+    int m_releaseRssThresholdMB;       ///< The resident memory, in MB, above which freed memory is released after an event (default 0, none)
+    int m_nEventsPerRelease;           ///< The number of events after which freed memory is released in any case (default 10, 0 for never)
+    int m_mmapThresholdKB;             ///< The fixed allocator mmap threshold when releasing memory, in kB (default 1024, 0 for dynamic)
+    bool m_shouldIndexEventFiles;      ///< Whether to write the event index of each pndr file in the event file list, then exit (default false)
 
     bool m_shouldRunAllHitsCosmicReco;  ///< Whether to run all hits cosmic-ray reconstruction
     bool m_shouldRunStitching;          ///< Whether to stitch cosmic-ray muons crossing between volumes
@@ -50,6 +82,64 @@ public:
     pandora::InputInt m_nEventsToSkip; ///< The number of events to skip
 };
 
+/**
+ *  @brief  EventObserver class, interface through which each event processed from an event queue is reported. Implementations must be
+ *          thread-safe, as events are reported from every worker thread.
+ */
+class EventObserver
+{
+public:
+    /**
+     *  @brief  Destructor
+     */
+    virtual ~EventObserver() = default;
+
+    /**
+     *  @brief  Report an event that has been read and is about to be processed, on the thread that will process it
+     *
+     *  @param  eventId the event id
+     */
+    virtual void EventStarted(const EventId &eventId);
+
+    /**
+     *  @brief  Report an event that has been read and processed
+     *
+     *  @param  eventId the event id
+     *  @param  readTime the time taken to read the event, in seconds
+     *  @param  processTime the time taken to process the event and reset the pandora instances, in seconds
+     */
+    virtual void EventProcessed(const EventId &eventId, const double readTime, const double processTime) = 0;
+};
+
+/**
+ *  @brief  EventObserverList class, forwarding each event report to a list of observers, in the order in which they were added
+ */
+class EventObserverList : public EventObserver
+{
+public:
+    /**
+     *  @brief  Add an observer to the list
+     *
+     *  @param  pEventObserver the address of the observer
+     */
+    void AddObserver(EventObserver *const pEventObserver);
+
+    /**
+     *  @brief  Whether the list contains no observers
+     *
+     *  @return boolean
+     */
+    bool IsEmpty() const;
+
+    void EventStarted(const EventId &eventId);
+    void EventProcessed(const EventId &eventId, const double readTime, const double processTime);
+
+private:
+    std::vector<EventObserver *> m_observerList; ///< The list of observers
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 /**
  *  @brief  Create pandora instances
  * 
@@ -58,6 +148,15 @@ public:
  */
 void CreatePandoraInstances(const Parameters &parameters, const pandora::Pandora *&pPrimaryPandora);
 
+/**
+ *  @brief  Create an independent set of pandora instances for each worker thread, and for each event to be prefetched. The event file
+ *          list is not passed to the instances, as events are instead read by the application itself.
+ *
+ *  @param  parameters the parameters
+ *  @param  primaryPandoraList to receive the addresses of the primary pandora instances
+ */
+void CreatePandoraInstances(const Parameters &parameters, PrimaryPandoraList &primaryPandoraList);
+
 /**
  *  @brief  Process events using the supplied pandora instances
  *
@@ -66,6 +165,84 @@ void CreatePandoraInstances(const Parameters &parameters, const pandora::Pandora
  */
 void ProcessEvents(const Parameters &parameters, const pandora::Pandora *const pPrimaryPandora);
 
+/**
+ *  @brief  Process events using one worker thread per primary pandora instance, with each thread drawing events from a shared queue. When
+ *          prefetching, there are instead parameters.m_nThreads worker threads, taking events read ahead into the spare instances.
+ *
+ *  @param  parameters the application parameters
+ *  @param  primaryPandoraList the list of primary pandora instances
+ *  @param  eventQueue the shared event queue
+ *  @param  pEventObserver the address of an observer to be notified of each processed event, if any
+ */
+void ProcessEventsConcurrently(const Parameters &parameters, const PrimaryPandoraList &primaryPandoraList, EventQueue &eventQueue,
+    EventObserver *const pEventObserver = nullptr);
+
+/**
+ *  @brief  Read and process events from the shared queue, using the supplied pandora instance, until the queue is exhausted
+ *
+ *  @param  parameters the application parameters
+ *  @param  eventReadingSettings the event reading settings
+ *  @param  pPrimaryPandora the address of the primary pandora instance
+ *  @param  eventQueue the shared event queue
+ *  @param  pEventObserver the address of an observer to be notified of each processed event, if any
+ */
+void ProcessQueuedEvents(const Parameters &parameters, const EventReadingSettings &eventReadingSettings, const pandora::Pandora *const pPrimaryPandora,
+    EventQueue &eventQueue, EventObserver *const pEventObserver);
+
+/**
+ *  @brief  Process events handed out by the prefetcher, each already read into its primary pandora instance, until none remain
+ *
+ *  @param  parameters the application parameters
+ *  @param  eventPrefetcher the event prefetcher
+ *  @param  pEventObserver the address of an observer to be notified of each processed event, if any
+ */
+void ProcessPrefetchedEvents(const Parameters &parameters, EventPrefetcher &eventPrefetcher, EventObserver *const pEventObserver);
+
+/**
+ *  @brief  Write the event index of each pndr file in the event file list, reading every event of any file without a current index
+ *
+ *  @param  parameters the application parameters
+ *  @param  pPrimaryPandora the address of the primary pandora instance into which to read the events
+ */
+void IndexEventFiles(const Parameters &parameters, const pandora::Pandora *const pPrimaryPandora);
+
+/**
+ *  @brief  Coordinate the processing of the event file list by worker processes, starting any requested local workers. Local workers
+ *          are forked from this process and return from this function to run as workers, in their own working directory.
+ *
+ *  @param  parameters the application parameters, modified to configure a worker if the function returns false
+ *
+ *  @return true in the coordinator process, false in a forked local worker process
+ */
+bool RunCoordinator(Parameters &parameters);
+
+/**
+ *  @brief  Configure a forked local worker process, moving to its own working directory so that its output files do not clash
+ *
+ *  @param  workerIndex the index of the local worker
+ *  @param  parameters the application parameters, to be modified to configure the worker
+ */
+void ConfigureLocalWorker(const unsigned int workerIndex, Parameters &parameters);
+
+/**
+ *  @brief  Get the absolute form of a file path, resolved against the current working directory
+ *
+ *  @param  path the file path
+ *
+ *  @return the absolute file path
+ */
+std::string GetAbsolutePath(const std::string &path);
+
+/**
+ *  @brief  Whether any algorithm or tool in a settings file, or in the settings files it names, is configured to write a file: a tree, event
+ *          or geometry file, or training sample
+ *
+ *  @param  settingsFile the settings file
+ *
+ *  @return whether file output is configured
+ */
+bool IsFileOutputConfigured(const std::string &settingsFile);
+
 /**
  *  @brief  Parse the command line arguments, setting the application parameters
  *
@@ -108,9 +285,29 @@ void ProcessExternalParameters(const Parameters &parameters, const pandora::Pand
 inline Parameters::Parameters() :
     m_settingsFile(""),
     m_eventFileNameList(""),
+    m_eventListFileName(""),
     m_geometryFileName(""),
     m_nEventsToProcess(-1),
     m_shouldDisplayEventNumber(false),
+    m_nThreads(1),
+    m_nEventsToPrefetch(0),
+    m_nTorchThreads(0),
+    m_nTorchInteropThreads(0),
+    m_coordinatorAddress(""),
+    m_workerAddress(""),
+    m_nLocalWorkers(0),
+    m_nEventsPerWorkUnit(10),
+    m_outputFileNameList(""),
+    m_daemonAddress(""),
+    m_daemonClientAddress(""),
+    m_timingFileName(""),
+    m_memoryFileName(""),
+    m_inferenceFileName(""),
+    m_shouldReleaseEventMemory(false),
+    m_releaseRssThresholdMB(0),
+    m_nEventsPerRelease(10),
+    m_mmapThresholdKB(1024),
+    m_shouldIndexEventFiles(false),
     m_shouldRunAllHitsCosmicReco(true),
     m_shouldRunStitching(true),
     m_shouldRunCosmicHitRemoval(true),
@@ -122,6 +319,26 @@ inline Parameters::Parameters() :
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void EventObserver::EventStarted(const EventId &)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void EventObserverList::AddObserver(EventObserver *const pEventObserver)
+{
+    m_observerList.push_back(pEventObserver);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool EventObserverList::IsEmpty() const
+{
+    return m_observerList.empty();
+}
+
 } // namespace lar_reco
 
 #endif // #ifndef PANDORA_INTERFACE_H
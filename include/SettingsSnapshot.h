@@ -0,0 +1,120 @@
+/**
+ *  @file   LArReco/include/SettingsSnapshot.h
+ *
+ *  @brief  Header file for the settings snapshot class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_SETTINGS_SNAPSHOT_H
+#define LAR_RECO_SETTINGS_SNAPSHOT_H 1
+
+#include <string>
+#include <vector>
+
+namespace pandora
+{
+class TiXmlElement;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  SettingsSnapshot class, writing an instrumented copy of a master settings file and the CR, Nu and Slicing settings files it
+ *          names into a single snapshot directory, for algorithm timing. Each snapshot file places a timing marker algorithm before each
+ *          top-level algorithm, and at the end, labelled with the pandora instance (Master, CR, Nu or Slicing) that runs it, and the
+ *          master algorithm is replaced with the timed master algorithm, which provides the markers to the daughter instances. The
+ *          master snapshot refers only to snapshot files. A manifest records the size and modification time of every source file, so
+ *          that a stale snapshot is detected and rewritten.
+ */
+class SettingsSnapshot
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  settingsFile the path to the master settings file
+     *  @param  snapshotDirectory the directory in which to store the snapshot
+     */
+    SettingsSnapshot(const std::string &settingsFile, const std::string &snapshotDirectory);
+
+    /**
+     *  @brief  Get the settings file to be passed to pandora, rebuilding the snapshot if it is missing or stale. Also adds the snapshot
+     *          directory to the front of FW_SEARCH_PATH, so that the snapshot files named in the master snapshot can be found.
+     *
+     *  @return the path to the master snapshot
+     */
+    std::string GetSettingsFile() const;
+
+private:
+    /**
+     *  @brief  SourceFile class, identifying a source settings file and the version used to create its snapshot
+     */
+    class SourceFile
+    {
+    public:
+        std::string     m_path;                 ///< The path to the source file
+        long long       m_modificationTime;     ///< The modification time of the source file
+        long long       m_size;                 ///< The size of the source file
+    };
+
+    typedef std::vector<SourceFile> SourceFileList;
+
+    /**
+     *  @brief  Whether the snapshot exists and was created from the current versions of all its source files
+     *
+     *  @return boolean
+     */
+    bool IsUpToDate() const;
+
+    /**
+     *  @brief  Write the snapshot files and manifest, replacing any existing snapshot
+     */
+    void Write() const;
+
+    /**
+     *  @brief  Write an instrumented copy of a settings file, renaming any settings files it names to their snapshot names
+     *
+     *  @param  sourcePath the path to the source settings file
+     *  @param  snapshotPath the path to the snapshot file
+     *  @param  instanceLabel the label for the pandora instance that reads the settings file
+     *  @param  sourceFileList to receive the source files that have been snapshotted, including any named settings files
+     */
+    void WriteSnapshotFile(const std::string &sourcePath, const std::string &snapshotPath, const std::string &instanceLabel,
+        SourceFileList &sourceFileList) const;
+
+    /**
+     *  @brief  Insert timing markers around the top-level algorithms of a settings file
+     *
+     *  @param  pPandoraElement the address of the top-level settings element
+     *  @param  instanceLabel the label for the pandora instance that reads the settings file
+     */
+    void InsertTimingMarkers(pandora::TiXmlElement *const pPandoraElement, const std::string &instanceLabel) const;
+
+    /**
+     *  @brief  Get the modification time and size of a file
+     *
+     *  @param  path the path to the file
+     *  @param  sourceFile to receive the file details
+     *
+     *  @return whether the file exists
+     */
+    static bool GetFileStatus(const std::string &path, SourceFile &sourceFile);
+
+    /**
+     *  @brief  Get the current value of FW_SEARCH_PATH, against which named settings files are resolved
+     *
+     *  @return the search path
+     */
+    static std::string GetSearchPath();
+
+    const std::string   m_settingsFile;         ///< The path to the master settings file
+    const std::string   m_snapshotDirectory;    ///< The directory in which to store the snapshot
+    const std::string   m_snapshotName;         ///< The name of the snapshot, derived from the master settings file name
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_SETTINGS_SNAPSHOT_H
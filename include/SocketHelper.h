@@ -0,0 +1,113 @@
+/**
+ *  @file   LArReco/include/SocketHelper.h
+ *
+ *  @brief  Header file for the socket helper class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_SOCKET_HELPER_H
+#define LAR_RECO_SOCKET_HELPER_H 1
+
+#include <string>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  SocketHelper class, providing line-based messaging over unix domain or tcp stream sockets. Addresses take the form
+ *          unix:<path> or <host>:<port>.
+ */
+class SocketHelper
+{
+public:
+    /**
+     *  @brief  Create a socket listening on the specified address
+     *
+     *  @param  address the address
+     *
+     *  @return the listening socket file descriptor
+     */
+    static int Listen(const std::string &address);
+
+    /**
+     *  @brief  Wait for an incoming connection on a listening socket
+     *
+     *  @param  listenSocket the listening socket file descriptor
+     *  @param  timeoutMilliseconds the maximum time to wait
+     *
+     *  @return the connected socket file descriptor, or -1 if no connection was made before the timeout
+     */
+    static int Accept(const int listenSocket, const int timeoutMilliseconds);
+
+    /**
+     *  @brief  Connect to the specified address
+     *
+     *  @param  address the address
+     *
+     *  @return the connected socket file descriptor, or -1 if the connection could not be made
+     */
+    static int Connect(const std::string &address);
+
+    /**
+     *  @brief  Close a socket, removing the socket file if it is a listening unix domain socket
+     *
+     *  @param  socket the socket file descriptor
+     *  @param  address the address, if the socket was created by Listen
+     */
+    static void Close(const int socket, const std::string &address = "");
+
+    /**
+     *  @brief  Read a newline-terminated message from a connected socket
+     *
+     *  @param  socket the socket file descriptor
+     *  @param  message to receive the message, without the terminating newline
+     *
+     *  @return whether a message was read, false if the connection has been closed
+     */
+    static bool ReadMessage(const int socket, std::string &message);
+
+    /**
+     *  @brief  Write a message to a connected socket, appending a terminating newline
+     *
+     *  @param  socket the socket file descriptor
+     *  @param  message the message
+     *
+     *  @return whether the message was written, false if the connection has been closed
+     */
+    static bool WriteMessage(const int socket, const std::string &message);
+
+    /**
+     *  @brief  Read a block of raw data from a connected socket
+     *
+     *  @param  socket the socket file descriptor
+     *  @param  nBytes the number of bytes to read
+     *  @param  data to receive the data
+     *
+     *  @return whether the data were read, false if the connection has been closed
+     */
+    static bool ReadData(const int socket, const std::size_t nBytes, std::string &data);
+
+    /**
+     *  @brief  Write a block of raw data to a connected socket
+     *
+     *  @param  socket the socket file descriptor
+     *  @param  data the data
+     *
+     *  @return whether the data were written, false if the connection has been closed
+     */
+    static bool WriteData(const int socket, const std::string &data);
+
+    /**
+     *  @brief  Get the form of an address to which a client may connect from any working directory, resolving the path of a unix
+     *          domain socket against the current working directory and directing a tcp address with no host to the local host
+     *
+     *  @param  address the address
+     *
+     *  @return the absolute address
+     */
+    static std::string GetAbsoluteAddress(const std::string &address);
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_SOCKET_HELPER_H
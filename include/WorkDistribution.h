@@ -0,0 +1,225 @@
+/**
+ *  @file   LArReco/include/WorkDistribution.h
+ *
+ *  @brief  Header file for the work coordinator and remote event queue, used to shard an event file list across worker processes.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_WORK_DISTRIBUTION_H
+#define LAR_RECO_WORK_DISTRIBUTION_H 1
+
+#include "EventReading.h"
+
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  RemoteEventQueue class, drawing ranges of events from a work coordinator and handing them out to local consumers
+ *
+ *  Messages sent to the coordinator:    REQUEST, ENDOFFILE <eventNumber> <nUnavailableEvents> <fileName>,
+ *                                       COMPLETE <firstEventNumber> <fileName>, FINISHED,
+ *                                       FILE <nBytes> <outputFileName> (followed by the file contents), MISSING <outputFileName>, END
+ *  Messages received from coordinator:  WORK <firstEventNumber> <nEvents> <fileName>, WAIT, DONE, OUTPUTS <outputFileNameList>
+ */
+class RemoteEventQueue : public EventQueue
+{
+public:
+    /**
+     *  @brief  Constructor, connecting to the coordinator
+     *
+     *  @param  coordinatorAddress the coordinator address, unix:<path> or <host>:<port>
+     */
+    RemoteEventQueue(const std::string &coordinatorAddress);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~RemoteEventQueue();
+
+    RemoteEventQueue(const RemoteEventQueue &) = delete;
+    RemoteEventQueue &operator=(const RemoteEventQueue &) = delete;
+
+    bool GetNextEvent(EventId &eventId);
+    void SetEndOfFile(const EventId &eventId);
+    void SetEventProcessed(const EventId &eventId);
+    void Abort();
+
+    /**
+     *  @brief  Report completion to the coordinator and send it the output files it requests from the working directory. This should
+     *          be called only after the pandora instances have been deleted, so that all output files have been written.
+     */
+    void SendOutputFiles();
+
+private:
+    /**
+     *  @brief  WorkUnit class, a range of events drawn from the coordinator
+     */
+    class WorkUnit
+    {
+    public:
+        std::string     m_fileName;            ///< The event file name
+        unsigned int    m_firstEventNumber;    ///< The first event number in the unit
+        unsigned int    m_nEvents;             ///< The number of events in the unit
+        unsigned int    m_nUnresolvedEvents;   ///< The number of events neither processed nor found to be unavailable
+    };
+
+    typedef std::list<WorkUnit> WorkUnitList;
+
+    /**
+     *  @brief  Record that events in a work unit need no further processing, reporting the unit to the coordinator once all of its
+     *          events are resolved. Mutex must be held.
+     *
+     *  @param  eventId the id of the first of the events
+     *  @param  nEvents the number of events
+     */
+    void SetEventsResolved(const EventId &eventId, const unsigned int nEvents);
+
+    std::mutex      m_mutex;               ///< The mutex protecting the queue state and socket
+    int             m_socket;              ///< The socket connected to the coordinator
+    std::string     m_fileName;            ///< The file name for the current range of events
+    unsigned int    m_nextEventNumber;     ///< The next event number to issue from the current range
+    unsigned int    m_nEventsInRange;      ///< The number of events remaining in the current range
+    WorkUnitList    m_workUnitList;        ///< The work units with events not yet resolved
+    bool            m_isAborted;           ///< Whether the queue has been aborted
+    bool            m_isDone;              ///< Whether the coordinator has no further work to offer
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  WorkCoordinator class, owning the event file list and handing out (file, event range) work units to connected workers
+ *
+ *  Workers draw a new work unit each time they run out, so faster workers naturally take on more of the event list. The work units
+ *  of a worker that disconnects before delivering its output files are returned to the queue, to be reprocessed by another worker. Once
+ *  no work remains, workers are told to wait until every issued work unit has been processed, so that reissued units still find a worker.
+ */
+class WorkCoordinator
+{
+public:
+    /**
+     *  @brief  Constructor, starting to listen for workers
+     *
+     *  @param  address the address on which to listen, unix:<path> or <host>:<port>
+     *  @param  eventFileNameList the colon-separated list of event file names
+     *  @param  nEventsToSkip the number of events to skip in the first file
+     *  @param  nEventsToProcess the number of events to process (negative for all events)
+     *  @param  nEventsPerWorkUnit the maximum number of events in each work unit
+     *  @param  outputFileNameList the colon-separated list of output files to gather from each worker
+     */
+    WorkCoordinator(const std::string &address, const std::string &eventFileNameList, const unsigned int nEventsToSkip,
+        const int nEventsToProcess, const unsigned int nEventsPerWorkUnit, const std::string &outputFileNameList);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~WorkCoordinator();
+
+    WorkCoordinator(const WorkCoordinator &) = delete;
+    WorkCoordinator &operator=(const WorkCoordinator &) = delete;
+
+    /**
+     *  @brief  Serve work units until all events have been processed and all worker outputs gathered
+     *
+     *  @param  nLocalWorkers the number of worker processes forked by this process, which are reaped as they finish
+     *
+     *  @return whether all work units were completed
+     */
+    bool Run(const unsigned int nLocalWorkers);
+
+    /**
+     *  @brief  Merge the output files gathered from the workers into a single file per output file name
+     */
+    void MergeOutputFiles() const;
+
+private:
+    /**
+     *  @brief  WorkUnit class
+     */
+    class WorkUnit
+    {
+    public:
+        std::string     m_fileName;            ///< The event file name
+        unsigned int    m_firstEventNumber;    ///< The first event number in the unit
+        unsigned int    m_nEvents;             ///< The number of events in the unit
+        bool            m_isProcessed;         ///< Whether the worker has processed the unit, though its output is not yet gathered
+    };
+
+    typedef std::vector<WorkUnit> WorkUnitList;
+    typedef std::map<std::string, pandora::StringVector> OutputFileMap;
+
+    /**
+     *  @brief  Converse with a single connected worker, until it disconnects
+     *
+     *  @param  connectionId the connection id
+     *  @param  socket the connected socket
+     */
+    void ServeWorker(const unsigned int connectionId, const int socket);
+
+    /**
+     *  @brief  Choose the reply to a work request from a connected worker
+     *
+     *  @param  connectionId the connection id
+     *
+     *  @return the reply message
+     */
+    std::string GetWorkReply(const unsigned int connectionId);
+
+    /**
+     *  @brief  Record that a work unit issued to a connected worker ends early, as its event file has ended
+     *
+     *  @param  connectionId the connection id
+     *  @param  eventId the id of the first unavailable event
+     *  @param  nUnavailableEvents the number of issued events found to be unavailable
+     */
+    void SetEndOfFile(const unsigned int connectionId, const EventId &eventId, const unsigned int nUnavailableEvents);
+
+    /**
+     *  @brief  Record that a work unit issued to a connected worker has been processed
+     *
+     *  @param  connectionId the connection id
+     *  @param  firstEventId the id of the first event in the work unit
+     */
+    void SetWorkUnitProcessed(const unsigned int connectionId, const EventId &firstEventId);
+
+    /**
+     *  @brief  Receive an output file from a connected worker
+     *
+     *  @param  connectionId the connection id
+     *  @param  socket the connected socket
+     *  @param  nBytes the size of the file
+     *  @param  outputFileName the output file name
+     *  @param  gatheredFileName to receive the name under which the worker copy of the output file is stored
+     *
+     *  @return whether the file was received
+     */
+    bool ReceiveOutputFile(const unsigned int connectionId, const int socket, const std::size_t nBytes, const std::string &outputFileName,
+        std::string &gatheredFileName) const;
+
+    /**
+     *  @brief  Whether all work has been issued, completed and gathered. Mutex must be held.
+     *
+     *  @return boolean
+     */
+    bool IsComplete();
+
+    const std::string                       m_address;                 ///< The address on which to listen
+    const unsigned int                      m_nEventsPerWorkUnit;      ///< The maximum number of events in each work unit
+    pandora::StringVector                   m_outputFileNameVector;    ///< The output files to gather from each worker
+    int                                     m_listenSocket;            ///< The listening socket
+
+    std::mutex                              m_mutex;                   ///< The mutex protecting the coordinator state
+    FileListEventQueue                      m_eventQueue;              ///< The queue of events not yet issued
+    std::deque<WorkUnit>                    m_returnedWorkUnits;       ///< Work units returned by disconnected workers, to be reissued
+    std::map<unsigned int, WorkUnitList>    m_issuedWorkUnitMap;       ///< The work units issued to each active connection
+    OutputFileMap                           m_gatheredFileMap;         ///< The gathered worker copies of each output file
+    unsigned int                            m_nConnections;            ///< The number of connections made so far
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_WORK_DISTRIBUTION_H
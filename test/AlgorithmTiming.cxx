@@ -0,0 +1,470 @@
+/**
+ *  @file   LArReco/test/AlgorithmTiming.cxx
+ *
+ *  @brief  Implementation of the algorithm timing classes.
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Helpers/XmlHelper.h"
+
+#ifdef LIBTORCH_DL
+#include "larpandoradlcontent/LArDLContent.h"
+
+#include <ATen/record_function.h>
+#endif
+
+#include "AlgorithmTiming.h"
+#include "EventReading.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace pandora;
+
+namespace
+{
+
+/**
+ *  @brief  Quote and escape a string for inclusion in json output
+ *
+ *  @param  input the input string
+ *
+ *  @return the json string
+ */
+std::string ToJsonString(const std::string &input)
+{
+    std::string output("\"");
+
+    for (const char character : input)
+    {
+        if (('"' == character) || ('\\' == character))
+            output.push_back('\\');
+
+        output.push_back(character);
+    }
+
+    return (output + "\"");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Whether an algorithm type is one of the deep learning algorithms, which prepare and run the network inference. The deep
+ *          learning master is excluded, as it steers the whole reconstruction.
+ *
+ *  @param  algorithmType the algorithm type
+ *
+ *  @return boolean
+ */
+bool IsDLAlgorithm(const std::string &algorithmType)
+{
+    return ((0 == algorithmType.compare(0, 5, "LArDL")) && ("LArDLMaster" != algorithmType));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  OperatorTiming class, describing the LibTorch operators run by a thread
+ */
+class OperatorTiming
+{
+public:
+    unsigned int                            m_depth = 0;    ///< The number of operators in progress
+    std::chrono::steady_clock::time_point   m_startTime;    ///< The start time of the outermost operator in progress
+    double                                  m_time = 0.;    ///< The time spent in operators since the thread last started an event, in seconds
+};
+
+/**
+ *  @brief  Get the operator timing of the calling thread
+ *
+ *  @return the operator timing
+ */
+OperatorTiming &GetThreadOperatorTiming()
+{
+    static thread_local OperatorTiming threadOperatorTiming;
+    return threadOperatorTiming;
+}
+
+#ifdef LIBTORCH_DL
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Record the start of a LibTorch operator
+ *
+ *  @return no observer context, the state being held per thread
+ */
+std::unique_ptr<at::ObserverContext> StartOperator(const at::RecordFunction &)
+{
+    OperatorTiming &operatorTiming(GetThreadOperatorTiming());
+
+    if (0 == operatorTiming.m_depth++)
+        operatorTiming.m_startTime = std::chrono::steady_clock::now();
+
+    return nullptr;
+}
+
+/**
+ *  @brief  Record the end of a LibTorch operator
+ */
+void EndOperator(const at::RecordFunction &, at::ObserverContext *)
+{
+    OperatorTiming &operatorTiming(GetThreadOperatorTiming());
+
+    // ATTN An operator already in progress when the callback was added is never started
+    if ((operatorTiming.m_depth > 0) && (0 == --operatorTiming.m_depth))
+        operatorTiming.m_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - operatorTiming.m_startTime).count();
+}
+#endif
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+TimingMarkerAlgorithm::TimingMarkerAlgorithm() :
+    m_instanceLabel(""),
+    m_nextAlgorithmType("")
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TimingMarkerAlgorithm::Run()
+{
+    AlgorithmTimingRecorder::RecordMarker(&this->GetPandora(), m_instanceLabel, m_nextAlgorithmType);
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TimingMarkerAlgorithm::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "InstanceLabel", m_instanceLabel));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(
+        STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "NextAlgorithm", m_nextAlgorithmType));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TimedMasterAlgorithm::RegisterCustomContent(const Pandora *const pPandora) const
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, MasterAlgorithm::RegisterCustomContent(pPandora));
+
+    // ATTN The timed master stands in for LArDLMaster too, so must also provide the deep learning content to the daughter instances
+#ifdef LIBTORCH_DL
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArDLContent::RegisterAlgorithms(*pPandora));
+#endif
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=,
+        PandoraApi::RegisterAlgorithmFactory(*pPandora, "LArRecoTimingMarker", new TimingMarkerAlgorithm::Factory));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmTimingRecorder::AlgorithmTimingRecorder(const std::string &outputFileName) :
+    m_outputFileName(outputFileName),
+    m_isJson((outputFileName.size() >= 5) && (0 == outputFileName.compare(outputFileName.size() - 5, 5, ".json"))),
+    m_outputFile(outputFileName, std::ios::trunc),
+    m_nEvents(0),
+    m_totalReadTime(0.),
+    m_totalProcessTime(0.),
+    m_totalDLTime(0.)
+{
+    if (!m_outputFile.is_open())
+    {
+        std::cout << "LArReco, unable to open timing file " << outputFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    if (m_isJson)
+    {
+        m_outputFile << "[";
+    }
+    else
+    {
+        m_outputFile << "fileName,eventNumber,instance,algorithm,calls,seconds" << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmTimingRecorder::~AlgorithmTimingRecorder()
+{
+    if (m_isJson)
+        m_outputFile << std::endl << "]" << std::endl;
+
+    m_outputFile.close();
+    this->WriteSummary();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmTimingRecorder::EventProcessed(const EventId &eventId, const double readTime, const double processTime)
+{
+    AlgorithmTimingMap eventTimingMap;
+    eventTimingMap.swap(AlgorithmTimingRecorder::GetThreadTimingMap());
+    AlgorithmTimingRecorder::GetThreadOpenTimingMap().clear();
+
+    AlgorithmTiming dlTiming;
+
+    for (const AlgorithmTimingMap::value_type &mapEntry : eventTimingMap)
+    {
+        if (IsDLAlgorithm(mapEntry.first.second))
+        {
+            dlTiming.m_nCalls += mapEntry.second.m_nCalls;
+            dlTiming.m_time += mapEntry.second.m_time;
+        }
+    }
+
+    std::ostringstream eventOutput;
+    eventOutput << std::setprecision(6);
+
+    if (m_isJson)
+    {
+        eventOutput << std::endl
+                    << "  {\"fileName\": " << ToJsonString(eventId.m_fileName) << ", \"eventNumber\": " << eventId.m_eventNumber
+                    << ", \"readSeconds\": " << readTime << ", \"processSeconds\": " << processTime
+                    << ", \"dlAlgorithmSeconds\": " << dlTiming.m_time << ", \"algorithms\": [";
+
+        for (AlgorithmTimingMap::const_iterator iter = eventTimingMap.begin(); iter != eventTimingMap.end(); ++iter)
+        {
+            eventOutput << ((eventTimingMap.begin() == iter) ? "" : ", ") << "{\"instance\": " << ToJsonString(iter->first.first)
+                        << ", \"algorithm\": " << ToJsonString(iter->first.second) << ", \"calls\": " << iter->second.m_nCalls
+                        << ", \"seconds\": " << iter->second.m_time << "}";
+        }
+
+        eventOutput << "]}";
+    }
+    else
+    {
+        const std::string eventPrefix(eventId.m_fileName + "," + std::to_string(eventId.m_eventNumber) + ",");
+        eventOutput << eventPrefix << "Event,Read,1," << readTime << std::endl << eventPrefix << "Event,Process,1," << processTime << std::endl;
+        eventOutput << eventPrefix << "Event,LArDLAlgorithms," << dlTiming.m_nCalls << "," << dlTiming.m_time << std::endl;
+
+        for (const AlgorithmTimingMap::value_type &mapEntry : eventTimingMap)
+        {
+            eventOutput << eventPrefix << mapEntry.first.first << "," << mapEntry.first.second << "," << mapEntry.second.m_nCalls << ","
+                        << mapEntry.second.m_time << std::endl;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outputFile << ((m_isJson && (m_nEvents > 0)) ? "," : "") << eventOutput.str();
+
+    for (const AlgorithmTimingMap::value_type &mapEntry : eventTimingMap)
+    {
+        AlgorithmTiming &jobTiming(m_jobTimingMap[mapEntry.first]);
+        jobTiming.m_nCalls += mapEntry.second.m_nCalls;
+        jobTiming.m_time += mapEntry.second.m_time;
+    }
+
+    ++m_nEvents;
+    m_totalReadTime += readTime;
+    m_totalProcessTime += processTime;
+    m_totalDLTime += dlTiming.m_time;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode AlgorithmTimingRecorder::RegisterAlgorithms(const Pandora &pandora)
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::RegisterAlgorithmFactory(pandora, "LArRecoTimingMarker", new TimingMarkerAlgorithm::Factory));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::RegisterAlgorithmFactory(pandora, "LArRecoTimedMaster", new TimedMasterAlgorithm::Factory));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmTimingRecorder::RecordMarker(const Pandora *const pPandora, const std::string &instanceLabel, const std::string &nextAlgorithmType)
+{
+    const std::chrono::steady_clock::time_point markerTime(std::chrono::steady_clock::now());
+    OpenTimingMap &openTimingMap(AlgorithmTimingRecorder::GetThreadOpenTimingMap());
+    OpenTimingMap::iterator iter(openTimingMap.find(pPandora));
+
+    if (openTimingMap.end() != iter)
+    {
+        AlgorithmTiming &algorithmTiming(AlgorithmTimingRecorder::GetThreadTimingMap()[TimingKey(iter->second.m_instanceLabel, iter->second.m_algorithmType)]);
+        ++algorithmTiming.m_nCalls;
+        algorithmTiming.m_time += std::chrono::duration<double>(markerTime - iter->second.m_startTime).count();
+        openTimingMap.erase(iter);
+    }
+
+    if (nextAlgorithmType.empty())
+        return;
+
+    OpenTiming &openTiming(openTimingMap[pPandora]);
+    openTiming.m_instanceLabel = instanceLabel;
+    openTiming.m_algorithmType = nextAlgorithmType;
+    openTiming.m_startTime = std::chrono::steady_clock::now();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmTimingRecorder::AlgorithmTimingMap &AlgorithmTimingRecorder::GetThreadTimingMap()
+{
+    static thread_local AlgorithmTimingMap threadTimingMap;
+    return threadTimingMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmTimingRecorder::OpenTimingMap &AlgorithmTimingRecorder::GetThreadOpenTimingMap()
+{
+    static thread_local OpenTimingMap threadOpenTimingMap;
+    return threadOpenTimingMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmTimingRecorder::WriteSummary() const
+{
+    typedef std::vector<AlgorithmTimingMap::const_iterator> TimingIterList;
+    TimingIterList timingIterList;
+
+    for (AlgorithmTimingMap::const_iterator iter = m_jobTimingMap.begin(); iter != m_jobTimingMap.end(); ++iter)
+        timingIterList.push_back(iter);
+
+    std::sort(timingIterList.begin(), timingIterList.end(),
+        [](const AlgorithmTimingMap::const_iterator &lhs, const AlgorithmTimingMap::const_iterator &rhs)
+        { return (lhs->second.m_time > rhs->second.m_time); });
+
+    const std::string::size_type extensionPosition(m_outputFileName.find_last_of('.'));
+    const std::string::size_type separatorPosition(m_outputFileName.find_last_of('/'));
+    const bool hasExtension(
+        (std::string::npos != extensionPosition) && ((std::string::npos == separatorPosition) || (extensionPosition > separatorPosition)));
+    const std::string summaryFileName(hasExtension ? m_outputFileName.substr(0, extensionPosition) + "_Summary" + m_outputFileName.substr(extensionPosition)
+                                                   : m_outputFileName + "_Summary");
+
+    std::ofstream summaryFile(summaryFileName, std::ios::trunc);
+    summaryFile << std::setprecision(6);
+
+    if (m_isJson)
+    {
+        summaryFile << "{\"nEvents\": " << m_nEvents << ", \"readSeconds\": " << m_totalReadTime << ", \"processSeconds\": " << m_totalProcessTime
+                    << ", \"dlAlgorithmSeconds\": " << m_totalDLTime << ", \"algorithms\": [";
+    }
+    else
+    {
+        summaryFile << "instance,algorithm,calls,seconds,secondsPerEvent,fractionOfProcessTime" << std::endl;
+    }
+
+    for (TimingIterList::const_iterator iter = timingIterList.begin(); iter != timingIterList.end(); ++iter)
+    {
+        const TimingKey &timingKey((*iter)->first);
+        const AlgorithmTiming &algorithmTiming((*iter)->second);
+        const double timePerEvent((m_nEvents > 0) ? algorithmTiming.m_time / m_nEvents : 0.);
+        const double timeFraction((m_totalProcessTime > 0.) ? algorithmTiming.m_time / m_totalProcessTime : 0.);
+
+        if (m_isJson)
+        {
+            summaryFile << ((timingIterList.begin() == iter) ? "" : ",") << std::endl
+                        << "  {\"instance\": " << ToJsonString(timingKey.first) << ", \"algorithm\": " << ToJsonString(timingKey.second)
+                        << ", \"calls\": " << algorithmTiming.m_nCalls << ", \"seconds\": " << algorithmTiming.m_time
+                        << ", \"secondsPerEvent\": " << timePerEvent << ", \"fractionOfProcessTime\": " << timeFraction << "}";
+        }
+        else
+        {
+            summaryFile << timingKey.first << "," << timingKey.second << "," << algorithmTiming.m_nCalls << "," << algorithmTiming.m_time << ","
+                        << timePerEvent << "," << timeFraction << std::endl;
+        }
+    }
+
+    if (m_isJson)
+        summaryFile << std::endl << "]}" << std::endl;
+
+    const unsigned int nAlgorithmsToPrint(std::min(static_cast<unsigned int>(timingIterList.size()), 10u));
+
+    std::cout << std::endl
+              << "LArReco, algorithm timing over " << m_nEvents << " events, " << m_totalProcessTime << " s processing, of which "
+              << m_totalDLTime << " s in LArDL algorithms, written to " << m_outputFileName << " and " << summaryFileName << std::endl;
+
+    for (unsigned int iAlgorithm = 0; iAlgorithm < nAlgorithmsToPrint; ++iAlgorithm)
+    {
+        const TimingKey &timingKey(timingIterList.at(iAlgorithm)->first);
+        const AlgorithmTiming &algorithmTiming(timingIterList.at(iAlgorithm)->second);
+
+        std::cout << "    " << std::left << std::setw(8) << timingKey.first << std::setw(48) << timingKey.second << std::right << std::setw(10)
+                  << algorithmTiming.m_nCalls << " calls" << std::setw(12) << std::fixed << std::setprecision(3) << algorithmTiming.m_time << " s"
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+InferenceTimingRecorder::InferenceTimingRecorder(const std::string &outputFileName) :
+    m_outputFileName(outputFileName),
+    m_outputFile(outputFileName, std::ios::trunc),
+    m_callbackHandle(0),
+    m_nEvents(0),
+    m_totalProcessTime(0.),
+    m_totalInferenceTime(0.)
+{
+    if (!m_outputFile.is_open())
+    {
+        std::cout << "LArReco, unable to open inference timing file " << outputFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    m_outputFile << "fileName,eventNumber,processSeconds,inferenceSeconds" << std::endl;
+
+#ifdef LIBTORCH_DL
+    m_callbackHandle = at::addGlobalCallback(at::RecordFunctionCallback(StartOperator, EndOperator).scopes({at::RecordScope::FUNCTION}));
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+InferenceTimingRecorder::~InferenceTimingRecorder()
+{
+#ifdef LIBTORCH_DL
+    at::removeCallback(m_callbackHandle);
+#endif
+    m_outputFile.close();
+
+    std::cout << std::endl
+              << "LArReco, inference timing over " << m_nEvents << " events, " << m_totalProcessTime << " s processing, of which "
+              << m_totalInferenceTime << " s in LibTorch operators, written to " << m_outputFileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void InferenceTimingRecorder::EventStarted(const EventId &)
+{
+    // ATTN Operators run while configuring the instances, or reading the event, are not attributed to the event
+    GetThreadOperatorTiming().m_time = 0.;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void InferenceTimingRecorder::EventProcessed(const EventId &eventId, const double, const double processTime)
+{
+    const double inferenceTime(GetThreadOperatorTiming().m_time);
+
+    std::ostringstream eventOutput;
+    eventOutput << std::setprecision(6) << eventId.m_fileName << "," << eventId.m_eventNumber << "," << processTime << "," << inferenceTime
+                << std::endl;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outputFile << eventOutput.str();
+
+    ++m_nEvents;
+    m_totalProcessTime += processTime;
+    m_totalInferenceTime += inferenceTime;
+}
+
+} // namespace lar_reco
@@ -0,0 +1,236 @@
+/**
+ *  @file   LArReco/test/EventDaemon.cxx
+ *
+ *  @brief  Implementation of the event daemon class.
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Helpers/XmlHelper.h"
+
+#include "EventDaemon.h"
+#include "EventReading.h"
+#include "SocketHelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+EventDaemon::EventDaemon(const Parameters &parameters, const PrimaryPandoraList &primaryPandoraList) :
+    m_parameters(parameters),
+    m_primaryPandoraList(primaryPandoraList),
+    m_listenSocket(SocketHelper::Listen(parameters.m_daemonAddress)),
+    m_clientSocket(-1),
+    m_nEventsProcessed(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventDaemon::~EventDaemon()
+{
+    SocketHelper::Close(m_listenSocket, m_parameters.m_daemonAddress);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventDaemon::Run()
+{
+    std::cout << "LArReco, daemon listening on " << m_parameters.m_daemonAddress << std::endl;
+
+    if (IsFileOutputConfigured(m_parameters.m_settingsFile))
+        std::cout << "LArReco, output files will hold the events of every request, and are only completed at daemon shutdown" << std::endl;
+
+    while (true)
+    {
+        const int socket(SocketHelper::Accept(m_listenSocket, -1));
+
+        if (socket < 0)
+            continue;
+
+        const bool shouldContinue(this->ServeClient(socket));
+        SocketHelper::Close(socket);
+
+        if (!shouldContinue)
+            break;
+    }
+
+    std::cout << "LArReco, daemon shutting down" << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventDaemon::EventProcessed(const EventId &eventId, const double readTime, const double processTime)
+{
+    std::ostringstream message;
+    message << "EVENT " << eventId.m_eventNumber << " " << std::fixed << std::setprecision(1) << (1000. * readTime) << " "
+            << (1000. * processTime) << " " << eventId.m_fileName;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_nEventsProcessed;
+
+    // ATTN A client that has gone away does not interrupt processing of its request
+    if (m_clientSocket >= 0)
+        SocketHelper::WriteMessage(m_clientSocket, message.str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventDaemon::SubmitRequest(const std::string &address, const std::string &eventFileNameList, const unsigned int nEventsToSkip,
+    const int nEventsToProcess)
+{
+    const int socket(SocketHelper::Connect(address));
+
+    if (socket < 0)
+    {
+        std::cout << "LArReco, unable to connect to daemon at " << address << std::endl;
+        return false;
+    }
+
+    // ATTN Event file names are made absolute, so that they can be opened from the working directory of the daemon
+    StringVector eventFileNameVector;
+    XmlHelper::TokenizeString(eventFileNameList, eventFileNameVector, ":");
+
+    std::string absoluteEventFileNameList;
+
+    for (const std::string &eventFileName : eventFileNameVector)
+        absoluteEventFileNameList += (absoluteEventFileNameList.empty() ? "" : ":") + GetAbsolutePath(eventFileName);
+
+    const std::string request(absoluteEventFileNameList.empty()
+            ? "SHUTDOWN"
+            : "PROCESS " + std::to_string(nEventsToSkip) + " " + std::to_string(nEventsToProcess) + " " + absoluteEventFileNameList);
+
+    bool isSuccess(false);
+    std::string reply;
+
+    if (SocketHelper::WriteMessage(socket, request))
+    {
+        while (SocketHelper::ReadMessage(socket, reply))
+        {
+            std::cout << reply << std::endl;
+
+            if ((0 == reply.compare(0, 4, "DONE")) || (0 == reply.compare(0, 3, "BYE")))
+            {
+                isSuccess = true;
+                break;
+            }
+
+            if (0 == reply.compare(0, 6, "FAILED"))
+                break;
+        }
+    }
+
+    SocketHelper::Close(socket);
+
+    if (!isSuccess)
+        std::cout << "LArReco, daemon request was not completed" << std::endl;
+
+    return isSuccess;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventDaemon::ServeClient(const int socket)
+{
+    std::string message;
+
+    while (SocketHelper::ReadMessage(socket, message))
+    {
+        std::istringstream messageStream(message);
+        std::string command;
+        messageStream >> command;
+
+        if ("PROCESS" == command)
+        {
+            int nEventsToSkip(-1), nEventsToProcess(0);
+            std::string eventFileNameList;
+            messageStream >> nEventsToSkip >> nEventsToProcess;
+            std::getline(messageStream >> std::ws, eventFileNameList);
+
+            if (!messageStream || (nEventsToSkip < 0) || eventFileNameList.empty())
+            {
+                SocketHelper::WriteMessage(socket, "FAILED 0 0 malformed request: " + message);
+                continue;
+            }
+
+            this->ProcessRequest(socket, eventFileNameList, nEventsToSkip, nEventsToProcess);
+        }
+        else if ("SHUTDOWN" == command)
+        {
+            SocketHelper::WriteMessage(socket, "BYE");
+            return false;
+        }
+        else
+        {
+            SocketHelper::WriteMessage(socket, "FAILED 0 0 unrecognised request: " + message);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventDaemon::ProcessRequest(const int socket, const std::string &eventFileNameList, const unsigned int nEventsToSkip, const int nEventsToProcess)
+{
+    const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_clientSocket = socket;
+        m_nEventsProcessed = 0;
+    }
+
+    bool isFailure(true);
+    std::string failureReason;
+
+    try
+    {
+        FileListEventQueue eventQueue(eventFileNameList, nEventsToSkip, nEventsToProcess);
+        ProcessEventsConcurrently(m_parameters, m_primaryPandoraList, eventQueue, this);
+        isFailure = false;
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        failureReason = statusCodeException.ToString();
+    }
+    catch (const std::exception &exception)
+    {
+        failureReason = exception.what();
+    }
+    catch (...)
+    {
+        failureReason = "unknown exception";
+    }
+
+    // Leave the instances ready for the next request, discarding any partially processed event
+    if (isFailure)
+    {
+        for (const Pandora *const pPrimaryPandora : m_primaryPandoraList)
+            PandoraApi::Reset(*pPrimaryPandora);
+
+        // ATTN Each reply is a single line, so the reason for the failure cannot span several
+        std::replace(failureReason.begin(), failureReason.end(), '\n', ' ');
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_clientSocket = -1;
+
+    std::ostringstream reply;
+    reply << (isFailure ? "FAILED " : "DONE ") << m_nEventsProcessed << " " << std::fixed << std::setprecision(3)
+          << std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()
+          << (isFailure ? " " + failureReason : "");
+
+    SocketHelper::WriteMessage(socket, reply.str());
+}
+
+} // namespace lar_reco
@@ -0,0 +1,259 @@
+/**
+ *  @file   LArReco/test/EventIndex.cxx
+ *
+ *  @brief  Implementation of the event index
+ *
+ *  $Log: $
+ */
+
+#include "Persistency/PandoraIO.h"
+
+#include "EventIndex.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace pandora;
+
+namespace
+{
+
+/**
+ *  @brief  IndexBuildState class, tracking the events read from a single event file
+ */
+class IndexBuildState
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    IndexBuildState();
+
+    lar_reco::EventIndex    m_eventIndex;       ///< The index being built
+    std::vector<bool>       m_isEventRead;      ///< Whether each event has been read
+    unsigned int            m_nEventsToRead;    ///< The number of events yet to be read
+    bool                    m_isBuilding;       ///< Whether the index is still being built
+};
+
+IndexBuildState::IndexBuildState() :
+    m_nEventsToRead(0),
+    m_isBuilding(false)
+{
+}
+
+std::mutex indexBuildMutex;                                     ///< The mutex protecting the index build states
+std::map<std::string, IndexBuildState> indexBuildStateMap;      ///< The index build state for each event file encountered
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+bool EventIndex::IsIndexable(const std::string &eventFileName)
+{
+    const std::string::size_type extensionPosition(eventFileName.find_last_of("."));
+    return ((std::string::npos != extensionPosition) && (".pndr" == eventFileName.substr(extensionPosition)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventIndex::Read(const std::string &eventFileName)
+{
+    m_entryList.clear();
+
+    std::int64_t fileSize(0), modificationTime(0);
+
+    if (!EventIndex::GetFileStatus(eventFileName, fileSize, modificationTime))
+        return false;
+
+    std::ifstream indexFile(EventIndex::GetIndexFileName(eventFileName));
+    std::string header;
+
+    if (!indexFile.is_open() || !std::getline(indexFile, header) || ("# LArReco event index v1" != header))
+        return false;
+
+    unsigned int nEvents(0);
+
+    if (!(indexFile >> m_fileSize >> m_modificationTime >> nEvents) || (fileSize != m_fileSize) || (modificationTime != m_modificationTime))
+        return false;
+
+    m_entryList.resize(nEvents);
+
+    for (unsigned int iEvent = 0; iEvent < nEvents; ++iEvent)
+    {
+        unsigned int eventNumber(0);
+        Entry &entry(m_entryList.at(iEvent));
+
+        if (!(indexFile >> eventNumber >> entry.m_byteOffset >> entry.m_nHits) || (iEvent != eventNumber))
+        {
+            m_entryList.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventIndex::Write(const std::string &eventFileName) const
+{
+    // ATTN The index is written under a temporary name and then renamed, so that concurrent jobs never see a partial index
+    const std::string indexFileName(EventIndex::GetIndexFileName(eventFileName));
+    const std::string temporaryFileName(indexFileName + "." + std::to_string(::getpid()));
+
+    {
+        std::ofstream indexFile(temporaryFileName, std::ios::trunc);
+
+        if (!indexFile.is_open())
+            return false;
+
+        indexFile << "# LArReco event index v1" << std::endl << m_fileSize << " " << m_modificationTime << " " << m_entryList.size() << std::endl;
+
+        for (unsigned int iEvent = 0; iEvent < m_entryList.size(); ++iEvent)
+            indexFile << iEvent << " " << m_entryList.at(iEvent).m_byteOffset << " " << m_entryList.at(iEvent).m_nHits << std::endl;
+
+        if (!indexFile.good())
+        {
+            std::remove(temporaryFileName.c_str());
+            return false;
+        }
+    }
+
+    if (0 != std::rename(temporaryFileName.c_str(), indexFileName.c_str()))
+    {
+        std::remove(temporaryFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventIndex::Scan(const std::string &eventFileName)
+{
+    m_entryList.clear();
+
+    if (!EventIndex::GetFileStatus(eventFileName, m_fileSize, m_modificationTime))
+        return false;
+
+    std::ifstream eventFile(eventFileName, std::ios::in | std::ios::binary);
+
+    if (!eventFile.is_open())
+        return false;
+
+    // The next container follows at the position of the current container plus its size
+    std::int64_t containerPosition(0);
+
+    while (containerPosition < m_fileSize)
+    {
+        bool isEventContainer(false);
+        std::int64_t containerSize(0);
+
+        if (!EventIndex::ReadContainerHeader(eventFile, containerPosition, isEventContainer, containerSize))
+        {
+            std::cout << "LArReco, unable to index event file " << eventFileName << ", unrecognised container at byte " << containerPosition
+                      << std::endl;
+            m_entryList.clear();
+            return false;
+        }
+
+        if (isEventContainer)
+            m_entryList.push_back(Entry{containerPosition, 0});
+
+        containerPosition += containerSize;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventIndex::ReadContainerHeader(std::istream &eventFile, const std::int64_t containerPosition, bool &isEventContainer,
+    std::int64_t &containerSize)
+{
+    // Each container begins with the pandora file hash, the container id and the size of the whole container, as written by the
+    // pandora binary file writer
+    std::remove_const<decltype(PANDORA_FILE_HASH)>::type fileHash(0);
+    ContainerId containerId(UNKNOWN_CONTAINER);
+    std::ifstream::pos_type size(0);
+
+    eventFile.clear();
+    eventFile.seekg(containerPosition, std::ios::beg);
+    eventFile.read(reinterpret_cast<char *>(&fileHash), sizeof(fileHash));
+    eventFile.read(reinterpret_cast<char *>(&containerId), sizeof(containerId));
+    eventFile.read(reinterpret_cast<char *>(&size), sizeof(size));
+
+    if (!eventFile.good() || (PANDORA_FILE_HASH != fileHash) || (static_cast<std::streamoff>(size) <= 0))
+        return false;
+
+    isEventContainer = (EVENT_CONTAINER == containerId);
+    containerSize = static_cast<std::streamoff>(size);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventIndex::GetFileStatus(const std::string &eventFileName, std::int64_t &fileSize, std::int64_t &modificationTime)
+{
+    struct stat fileStatus;
+
+    if (0 != ::stat(eventFileName.c_str(), &fileStatus))
+        return false;
+
+    fileSize = fileStatus.st_size;
+    modificationTime = fileStatus.st_mtime;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventIndexBuilder::EventRead(const std::string &eventFileName, const unsigned int eventNumber, const unsigned int nHits)
+{
+    std::lock_guard<std::mutex> lock(indexBuildMutex);
+
+    const bool isNewFile(!indexBuildStateMap.count(eventFileName));
+    IndexBuildState &indexBuildState(indexBuildStateMap[eventFileName]);
+
+    if (isNewFile)
+    {
+        // ATTN Another job may already have indexed the file, otherwise the event positions are found from the container headers
+        EventIndex currentIndex;
+
+        if (EventIndex::IsIndexable(eventFileName) && !currentIndex.Read(eventFileName) && indexBuildState.m_eventIndex.Scan(eventFileName))
+        {
+            indexBuildState.m_isEventRead.resize(indexBuildState.m_eventIndex.GetNEvents(), false);
+            indexBuildState.m_nEventsToRead = indexBuildState.m_eventIndex.GetNEvents();
+            indexBuildState.m_isBuilding = true;
+        }
+    }
+
+    if (!indexBuildState.m_isBuilding || (eventNumber >= indexBuildState.m_isEventRead.size()) || indexBuildState.m_isEventRead.at(eventNumber))
+        return;
+
+    indexBuildState.m_eventIndex.SetNHits(eventNumber, nHits);
+    indexBuildState.m_isEventRead.at(eventNumber) = true;
+
+    if (0 != --indexBuildState.m_nEventsToRead)
+        return;
+
+    if (!indexBuildState.m_eventIndex.Write(eventFileName))
+        std::cout << "LArReco, unable to write event index " << EventIndex::GetIndexFileName(eventFileName) << std::endl;
+
+    indexBuildState.m_eventIndex = EventIndex();
+    indexBuildState.m_isEventRead.clear();
+    indexBuildState.m_isBuilding = false;
+}
+
+} // namespace lar_reco
@@ -0,0 +1,167 @@
+/**
+ *  @file   LArReco/test/EventPrefetching.cxx
+ *
+ *  @brief  Implementation of the event prefetcher
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "EventPrefetching.h"
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+EventPrefetcher::EventPrefetcher(const PrimaryPandoraList &primaryPandoraList, const EventReadingSettings &eventReadingSettings, EventQueue &eventQueue) :
+    m_eventQueue(eventQueue),
+    m_isReadingComplete(false),
+    m_isAborted(false)
+{
+    for (const Pandora *const pPrimaryPandora : primaryPandoraList)
+    {
+        m_eventReaderMap[pPrimaryPandora] = std::unique_ptr<EventReader>(new EventReader(*pPrimaryPandora, eventReadingSettings));
+        m_idleQueue.push_back(pPrimaryPandora);
+    }
+
+    m_readingThread = std::thread(&EventPrefetcher::ReadEvents, this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventPrefetcher::~EventPrefetcher()
+{
+    this->Abort();
+    m_readingThread.join();
+
+    // ATTN Leave the instances ready for reuse, e.g. by the next daemon request
+    for (const StagedEvent &stagedEvent : m_stagedEventQueue)
+        (void)PandoraApi::Reset(*stagedEvent.m_pPrimaryPandora);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventPrefetcher::GetNextEvent(const Pandora *&pPrimaryPandora, EventId &eventId)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_conditionVariable.wait(lock, [this]() { return (m_isAborted || m_isReadingComplete || !m_stagedEventQueue.empty()); });
+
+    if (m_isAborted)
+        return false;
+
+    if (m_stagedEventQueue.empty())
+    {
+        if (m_pReadingException)
+            std::rethrow_exception(m_pReadingException);
+
+        return false;
+    }
+
+    pPrimaryPandora = m_stagedEventQueue.front().m_pPrimaryPandora;
+    eventId = m_stagedEventQueue.front().m_eventId;
+    m_stagedEventQueue.pop_front();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventPrefetcher::ReleaseEvent(const Pandora *const pPrimaryPandora, const EventId &eventId)
+{
+    m_eventQueue.SetEventProcessed(eventId);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_idleQueue.push_back(pPrimaryPandora);
+    }
+
+    m_conditionVariable.notify_all();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventPrefetcher::Abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isAborted = true;
+    }
+
+    m_conditionVariable.notify_all();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventPrefetcher::ReadEvents()
+{
+    try
+    {
+        while (true)
+        {
+            const Pandora *pPrimaryPandora(nullptr);
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_conditionVariable.wait(lock, [this]() { return (m_isAborted || !m_idleQueue.empty()); });
+
+                if (m_isAborted)
+                    break;
+
+                pPrimaryPandora = m_idleQueue.front();
+                m_idleQueue.pop_front();
+            }
+
+            EventReader &eventReader(*m_eventReaderMap.at(pPrimaryPandora));
+            EventId eventId;
+            bool isEventRead(false);
+
+            while (!isEventRead && m_eventQueue.GetNextEvent(eventId))
+            {
+                if (STATUS_CODE_SUCCESS == eventReader.ReadEvent(eventId))
+                {
+                    isEventRead = true;
+                }
+                else
+                {
+                    m_eventQueue.SetEndOfFile(eventId);
+                    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (isEventRead)
+                {
+                    m_stagedEventQueue.push_back(StagedEvent{pPrimaryPandora, eventId});
+                }
+                else
+                {
+                    m_idleQueue.push_back(pPrimaryPandora);
+                    m_isReadingComplete = true;
+                }
+            }
+
+            m_conditionVariable.notify_all();
+
+            if (!isEventRead)
+                break;
+        }
+    }
+    catch (...)
+    {
+        m_eventQueue.Abort();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pReadingException = std::current_exception();
+            m_isReadingComplete = true;
+        }
+
+        m_conditionVariable.notify_all();
+    }
+}
+
+} // namespace lar_reco
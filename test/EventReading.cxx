@@ -0,0 +1,634 @@
+/**
+ *  @file   LArReco/test/EventReading.cxx
+ *
+ *  @brief  Implementation of the event queue and event reader
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Helpers/XmlHelper.h"
+#include "Persistency/BinaryFileReader.h"
+#include "Persistency/XmlFileReader.h"
+#include "Xml/tinyxml.h"
+
+#include "larpandoracontent/LArObjects/LArCaloHit.h"
+#include "larpandoracontent/LArObjects/LArMCParticle.h"
+
+#include "EventReading.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+#include <unistd.h>
+
+using namespace pandora;
+
+namespace
+{
+
+/**
+ *  @brief  CountingLArCaloHitFactory class, counting the lar calo hits that it creates
+ */
+class CountingLArCaloHitFactory : public lar_content::LArCaloHitFactory
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  version the lar calo hit version
+     *  @param  nHits the counter to increment for each calo hit created
+     */
+    CountingLArCaloHitFactory(const unsigned int version, unsigned int &nHits);
+
+    pandora::StatusCode Create(const Parameters &parameters, const Object *&pObject) const;
+
+private:
+    unsigned int   &m_nHits;    ///< The counter to increment for each calo hit created
+};
+
+CountingLArCaloHitFactory::CountingLArCaloHitFactory(const unsigned int version, unsigned int &nHits) :
+    lar_content::LArCaloHitFactory(version),
+    m_nHits(nHits)
+{
+}
+
+pandora::StatusCode CountingLArCaloHitFactory::Create(const Parameters &parameters, const Object *&pObject) const
+{
+    ++m_nHits;
+    return lar_content::LArCaloHitFactory::Create(parameters, pObject);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Parse a token consisting solely of a number
+ *
+ *  @param  token the token
+ *  @param  value to receive the value
+ *
+ *  @return success
+ */
+template <typename T>
+bool ParseNumber(const std::string &token, T &value)
+{
+    std::istringstream tokenStream(token);
+    return ((tokenStream >> value) && tokenStream.eof());
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+void ReadEventReadingSettings(const std::string &settingsFile, EventReadingSettings &eventReadingSettings)
+{
+    TiXmlDocument xmlDocument(settingsFile);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "LArReco, unable to load settings file " << settingsFile << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    const TiXmlHandle xmlDocumentHandle(&xmlDocument);
+    const TiXmlHandle xmlHandle(TiXmlHandle(xmlDocumentHandle.FirstChildElement().Element()));
+
+    for (TiXmlElement *pXmlElement = xmlHandle.FirstChild("algorithm").Element(); nullptr != pXmlElement;
+         pXmlElement = pXmlElement->NextSiblingElement("algorithm"))
+    {
+        const char *const pAlgorithmType(pXmlElement->Attribute("type"));
+
+        if (!pAlgorithmType || (std::string("LArEventReading") != pAlgorithmType))
+            continue;
+
+        const TiXmlHandle algorithmHandle(pXmlElement);
+        PANDORA_THROW_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=,
+            XmlHelper::ReadValue(algorithmHandle, "UseLArCaloHits", eventReadingSettings.m_useLArCaloHits));
+        PANDORA_THROW_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=,
+            XmlHelper::ReadValue(algorithmHandle, "LArCaloHitVersion", eventReadingSettings.m_larCaloHitVersion));
+        PANDORA_THROW_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=,
+            XmlHelper::ReadValue(algorithmHandle, "UseLArMCParticles", eventReadingSettings.m_useLArMCParticles));
+        PANDORA_THROW_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=,
+            XmlHelper::ReadValue(algorithmHandle, "LArMCParticleVersion", eventReadingSettings.m_larMCParticleVersion));
+        return;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+FileListEventQueue::FileListEventQueue(const std::string &eventFileNameList, const unsigned int nEventsToSkip, const int nEventsToProcess) :
+    m_fileIndex(0),
+    m_nextEventNumber(nEventsToSkip),
+    m_nEventsRemaining(nEventsToProcess),
+    m_isAborted(false)
+{
+    XmlHelper::TokenizeString(eventFileNameList, m_fileNameVector, ":");
+    m_endOfFileList.resize(m_fileNameVector.size(), std::numeric_limits<unsigned int>::max());
+
+    for (unsigned int iFile = 0; iFile < m_fileNameVector.size(); ++iFile)
+    {
+        EventIndex eventIndex;
+
+        if (EventIndex::IsIndexable(m_fileNameVector.at(iFile)) && eventIndex.Read(m_fileNameVector.at(iFile)))
+            m_endOfFileList.at(iFile) = eventIndex.GetNEvents();
+    }
+
+    // ATTN Events to be skipped beyond the end of an indexed file are skipped in the subsequent files
+    while ((m_fileIndex + 1 < m_fileNameVector.size()) && (m_nextEventNumber >= m_endOfFileList.at(m_fileIndex)) &&
+        (std::numeric_limits<unsigned int>::max() != m_endOfFileList.at(m_fileIndex)))
+    {
+        m_nextEventNumber -= m_endOfFileList.at(m_fileIndex);
+        ++m_fileIndex;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool FileListEventQueue::GetNextEvent(EventId &eventId)
+{
+    unsigned int nEvents(0);
+    return this->GetNextEventRange(1, eventId, nEvents);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void FileListEventQueue::SetEndOfFile(const EventId &eventId)
+{
+    this->SetEndOfFile(eventId, 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void FileListEventQueue::Abort()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isAborted = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool FileListEventQueue::GetNextEventRange(const unsigned int maxNEvents, EventId &firstEventId, unsigned int &nEvents)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ((0 == maxNEvents) || !this->AdvanceFile())
+        return false;
+
+    nEvents = std::min(maxNEvents, m_endOfFileList.at(m_fileIndex) - m_nextEventNumber);
+
+    if (m_nEventsRemaining >= 0)
+        nEvents = std::min(nEvents, static_cast<unsigned int>(m_nEventsRemaining));
+
+    firstEventId = EventId(m_fileNameVector.at(m_fileIndex), m_nextEventNumber);
+    m_nextEventNumber += nEvents;
+
+    if (m_nEventsRemaining >= 0)
+        m_nEventsRemaining -= nEvents;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void FileListEventQueue::SetEndOfFile(const EventId &eventId, const unsigned int nUnavailableEvents)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // ATTN The same file may legitimately appear more than once in the list, in which case it ends at the same event each time
+    for (unsigned int iFile = 0; iFile < m_fileNameVector.size(); ++iFile)
+    {
+        if (m_fileNameVector.at(iFile) == eventId.m_fileName)
+            m_endOfFileList.at(iFile) = std::min(m_endOfFileList.at(iFile), eventId.m_eventNumber);
+    }
+
+    // The unavailable events should not count towards the number of events to process
+    if (m_nEventsRemaining >= 0)
+        m_nEventsRemaining += nUnavailableEvents;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool FileListEventQueue::IsExhausted()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !this->AdvanceFile();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool FileListEventQueue::AdvanceFile()
+{
+    while ((m_fileIndex < m_fileNameVector.size()) && (m_nextEventNumber >= m_endOfFileList.at(m_fileIndex)))
+    {
+        ++m_fileIndex;
+        m_nextEventNumber = 0;
+    }
+
+    return (!m_isAborted && (0 != m_nEventsRemaining) && (m_fileIndex < m_fileNameVector.size()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventListQueue::EventListQueue(
+    const std::string &eventListFileName, const std::string &eventFileNameList, const unsigned int nEventsToSkip, const int nEventsToProcess) :
+    m_nextEventIndex(0),
+    m_isAborted(false)
+{
+    StringVector fileNameVector;
+    XmlHelper::TokenizeString(eventFileNameList, fileNameVector, ":");
+
+    EventNumberList endOfFileList(fileNameVector.size(), std::numeric_limits<unsigned int>::max());
+
+    for (unsigned int iFile = 0; iFile < fileNameVector.size(); ++iFile)
+    {
+        EventIndex eventIndex;
+
+        if (EventIndex::IsIndexable(fileNameVector.at(iFile)) && eventIndex.Read(fileNameVector.at(iFile)))
+            endOfFileList.at(iFile) = eventIndex.GetNEvents();
+    }
+
+    std::ifstream eventListFile(eventListFileName);
+
+    if (!eventListFile.is_open())
+    {
+        std::cout << "LArReco, unable to open event list " << eventListFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    std::string line;
+    unsigned int lineNumber(0);
+    std::string validationFileToken;
+
+    while (std::getline(eventListFile, line))
+    {
+        ++lineNumber;
+
+        if (line.empty() || ('#' == line[0]))
+            continue;
+
+        std::string fileToken, eventToken;
+        const std::string::size_type fileIdPosition(line.find("fileId:")), eventNumberPosition(line.find("eventNumber:"));
+        const bool isValidationLine((std::string::npos != fileIdPosition) && (std::string::npos != eventNumberPosition));
+
+        if (isValidationLine)
+        {
+            std::istringstream(line.substr(fileIdPosition + 7)) >> fileToken;
+            std::istringstream(line.substr(eventNumberPosition + 12)) >> eventToken;
+        }
+        else
+        {
+            std::istringstream(line) >> fileToken >> eventToken;
+        }
+
+        fileToken = fileToken.substr(0, fileToken.find(','));
+        eventToken = eventToken.substr(0, eventToken.find(','));
+
+        std::string fileName(fileToken);
+        int fileIdentifier(-1);
+        unsigned int eventNumber(0);
+
+        if (!ParseNumber(eventToken, eventNumber) || fileToken.empty())
+        {
+            std::cout << "LArReco, unable to parse line " << lineNumber << " of event list " << eventListFileName << ": " << line << std::endl;
+            throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+        }
+
+        if (isValidationLine)
+        {
+            // ATTN The validation file identifier labels a whole job, so identifies no file, and a single job can be located
+            if (!validationFileToken.empty() && (fileToken != validationFileToken))
+            {
+                std::cout << "LArReco, line " << lineNumber << " of event list " << eventListFileName << " has validation file identifier "
+                          << fileToken << ", but earlier lines have " << validationFileToken << ", so come from a different job" << std::endl;
+                throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+            }
+
+            validationFileToken = fileToken;
+            EventId eventId;
+
+            if (!EventListQueue::GetValidationEventId(fileNameVector, endOfFileList, nEventsToSkip, eventNumber, eventId))
+            {
+                std::cout << "LArReco, unable to locate validation event " << eventNumber << " on line " << lineNumber << " of event list "
+                          << eventListFileName << ": every file but the last in the event file list of the job must be indexed" << std::endl;
+                throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+            }
+
+            m_eventIdList.push_back(eventId);
+            continue;
+        }
+
+        if (ParseNumber(fileToken, fileIdentifier))
+        {
+            if ((fileIdentifier < 0) || (static_cast<unsigned int>(fileIdentifier) >= fileNameVector.size()))
+            {
+                std::cout << "LArReco, file identifier " << fileIdentifier << " on line " << lineNumber << " of event list " << eventListFileName
+                          << " is not in the event file list" << std::endl;
+                throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+            }
+
+            fileName = fileNameVector.at(fileIdentifier);
+        }
+
+        m_eventIdList.emplace_back(fileName, eventNumber);
+    }
+
+    // Order by position of the file in the event file list, with any other files following in order of name, then by event number
+    auto fileRank = [&fileNameVector](const std::string &fileName)
+    {
+        return std::make_pair(static_cast<std::size_t>(std::find(fileNameVector.begin(), fileNameVector.end(), fileName) - fileNameVector.begin()), fileName);
+    };
+
+    std::sort(m_eventIdList.begin(), m_eventIdList.end(),
+        [&fileRank](const EventId &lhs, const EventId &rhs)
+        {
+            return std::make_pair(fileRank(lhs.m_fileName), lhs.m_eventNumber) < std::make_pair(fileRank(rhs.m_fileName), rhs.m_eventNumber);
+        });
+
+    m_eventIdList.erase(std::unique(m_eventIdList.begin(), m_eventIdList.end(),
+                            [](const EventId &lhs, const EventId &rhs)
+                            { return ((lhs.m_fileName == rhs.m_fileName) && (lhs.m_eventNumber == rhs.m_eventNumber)); }),
+        m_eventIdList.end());
+
+    if ((nEventsToProcess >= 0) && (static_cast<unsigned int>(nEventsToProcess) < m_eventIdList.size()))
+        m_eventIdList.resize(nEventsToProcess, EventId());
+
+    std::cout << "LArReco, processing " << m_eventIdList.size() << " events from event list " << eventListFileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventListQueue::GetNextEvent(EventId &eventId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_isAborted || (m_nextEventIndex >= m_eventIdList.size()))
+        return false;
+
+    eventId = m_eventIdList.at(m_nextEventIndex++);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventListQueue::SetEndOfFile(const EventId &eventId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cout << "LArReco, listed event " << eventId.m_eventNumber << " is beyond the end of " << eventId.m_fileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventListQueue::Abort()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isAborted = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventListQueue::GetValidationEventId(const StringVector &fileNameVector, const EventNumberList &endOfFileList, const unsigned int nEventsToSkip,
+    const unsigned int processedEventNumber, EventId &eventId)
+{
+    if (fileNameVector.empty())
+        return false;
+
+    // The job skipped events from the start of its event file list, then processed its events in order through the list
+    unsigned int fileIndex(0), eventNumber(nEventsToSkip + processedEventNumber);
+
+    while ((fileIndex + 1 < fileNameVector.size()) && (eventNumber >= endOfFileList.at(fileIndex)))
+    {
+        eventNumber -= endOfFileList.at(fileIndex);
+        ++fileIndex;
+    }
+
+    // ATTN The end of an unindexed file is unknown, so an event can only be placed in such a file if no later file could hold it
+    if ((fileIndex + 1 < fileNameVector.size()) && (std::numeric_limits<unsigned int>::max() == endOfFileList.at(fileIndex)))
+        return false;
+
+    eventId = EventId(fileNameVector.at(fileIndex), eventNumber);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventReader::EventReader(const Pandora &pandora, const EventReadingSettings &eventReadingSettings) :
+    m_pandora(pandora),
+    m_eventReadingSettings(eventReadingSettings),
+    m_pFileReader(nullptr),
+    m_fileName(""),
+    m_nextEventNumber(0),
+    m_endEventNumber(std::numeric_limits<unsigned int>::max()),
+    m_nWindowEvents(0),
+    m_isIndexed(false),
+    m_shouldBuildIndex(false),
+    m_nHits(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventReader::~EventReader()
+{
+    delete m_pFileReader;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode EventReader::ReadEvent(const EventId &eventId)
+{
+    if (!m_pFileReader || (eventId.m_fileName != m_fileName))
+        this->ReplaceFileReader(eventId.m_fileName);
+
+    if (m_isIndexed && (eventId.m_eventNumber >= m_eventIndex.GetNEvents()))
+        return STATUS_CODE_NOT_FOUND;
+
+    if ((eventId.m_eventNumber != m_nextEventNumber) || (eventId.m_eventNumber >= m_endEventNumber))
+    {
+        if (m_isIndexed)
+            m_nWindowEvents = (eventId.m_eventNumber == m_nextEventNumber) ? std::min(2 * m_nWindowEvents, MAX_N_WINDOW_EVENTS) : 1;
+
+        // ATTN Should a window not be available, the event is reached by the pandora file reader, from the start of the event file
+        if (!m_isIndexed || !this->ReplaceWithEventWindow(eventId.m_eventNumber))
+        {
+            if (m_isIndexed || (eventId.m_eventNumber < m_nextEventNumber))
+                this->ReplaceFileReader(eventId.m_fileName);
+
+            if ((eventId.m_eventNumber != m_nextEventNumber) && (STATUS_CODE_SUCCESS != m_pFileReader->GoToEvent(eventId.m_eventNumber)))
+            {
+                m_fileName.clear();
+                return STATUS_CODE_NOT_FOUND;
+            }
+
+            m_nextEventNumber = eventId.m_eventNumber;
+        }
+    }
+
+    m_nHits = 0;
+
+    if (STATUS_CODE_SUCCESS != m_pFileReader->ReadEvent())
+    {
+        m_fileName.clear();
+        return STATUS_CODE_NOT_FOUND;
+    }
+
+    if (m_shouldBuildIndex)
+        EventIndexBuilder::EventRead(m_fileName, m_nextEventNumber, m_nHits);
+
+    ++m_nextEventNumber;
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventReader::ReplaceFileReader(const std::string &fileName)
+{
+    delete m_pFileReader;
+    m_pFileReader = nullptr;
+    m_fileName.clear();
+    m_nextEventNumber = 0;
+    m_endEventNumber = std::numeric_limits<unsigned int>::max();
+    m_nWindowEvents = 0;
+    m_isIndexed = false;
+    m_shouldBuildIndex = false;
+
+    m_pFileReader = this->CreateFileReader(fileName);
+
+    // ATTN Hits are only counted for lar calo hits, so indices are only built from events read with the lar calo hit factory
+    m_isIndexed = EventIndex::IsIndexable(fileName) && m_eventIndex.Read(fileName);
+    m_shouldBuildIndex = EventIndex::IsIndexable(fileName) && !m_isIndexed && m_eventReadingSettings.m_useLArCaloHits;
+    m_fileName = fileName;
+
+    if (m_isIndexed)
+        m_endEventNumber = m_eventIndex.GetNEvents();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventReader::ReplaceWithEventWindow(const unsigned int firstEventNumber)
+{
+    std::ifstream eventFile(m_fileName, std::ios::in | std::ios::binary);
+
+    if (!eventFile.is_open())
+        return false;
+
+    // The window holds at least the requested event, with the following events added until the window is full
+    std::string windowContents;
+    unsigned int endEventNumber(firstEventNumber);
+
+    while ((endEventNumber < m_eventIndex.GetNEvents()) && (endEventNumber - firstEventNumber < m_nWindowEvents) &&
+        (static_cast<std::int64_t>(windowContents.size()) < MAX_WINDOW_SIZE))
+    {
+        const std::int64_t containerPosition(m_eventIndex.GetByteOffset(endEventNumber));
+        bool isEventContainer(false);
+        std::int64_t containerSize(0);
+
+        if (!EventIndex::ReadContainerHeader(eventFile, containerPosition, isEventContainer, containerSize) || !isEventContainer)
+        {
+            std::cout << "LArReco, event " << endEventNumber << " not found at its indexed position in " << m_fileName << std::endl;
+            return false;
+        }
+
+        const std::string::size_type windowSize(windowContents.size());
+        windowContents.resize(windowSize + containerSize);
+        eventFile.seekg(containerPosition, std::ios::beg);
+        eventFile.read(&windowContents[windowSize], containerSize);
+
+        if (!eventFile.good())
+            return false;
+
+        ++endEventNumber;
+    }
+
+    if (endEventNumber == firstEventNumber)
+        return false;
+
+    // ATTN The window file is removed once opened by the file reader, which can continue to read it until the reader is deleted
+    const char *const pTemporaryDirectory(std::getenv("TMPDIR"));
+    std::string windowFileName(std::string((pTemporaryDirectory && *pTemporaryDirectory) ? pTemporaryDirectory : "/tmp") + "/LArRecoEvents_XXXXXX.pndr");
+    const int fileDescriptor(::mkstemps(&windowFileName[0], 5));
+
+    if (fileDescriptor < 0)
+        return false;
+
+    ::close(fileDescriptor);
+
+    {
+        std::ofstream windowFile(windowFileName, std::ios::binary | std::ios::trunc);
+        windowFile.write(windowContents.data(), windowContents.size());
+
+        if (!windowFile.good())
+        {
+            std::remove(windowFileName.c_str());
+            return false;
+        }
+    }
+
+    FileReader *pFileReader(nullptr);
+
+    try
+    {
+        pFileReader = this->CreateFileReader(windowFileName);
+    }
+    catch (...)
+    {
+        std::remove(windowFileName.c_str());
+        throw;
+    }
+
+    std::remove(windowFileName.c_str());
+
+    delete m_pFileReader;
+    m_pFileReader = pFileReader;
+    m_nextEventNumber = firstEventNumber;
+    m_endEventNumber = endEventNumber;
+    m_nWindowEvents = endEventNumber - firstEventNumber;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+FileReader *EventReader::CreateFileReader(const std::string &fileName)
+{
+    const std::string::size_type extensionPosition(fileName.find_last_of("."));
+    const std::string fileExtension((std::string::npos != extensionPosition) ? fileName.substr(extensionPosition) : "");
+    std::unique_ptr<FileReader> pFileReader;
+
+    if (".pndr" == fileExtension)
+    {
+        pFileReader.reset(new BinaryFileReader(m_pandora, fileName));
+    }
+    else if (".xml" == fileExtension)
+    {
+        pFileReader.reset(new XmlFileReader(m_pandora, fileName));
+    }
+    else
+    {
+        std::cout << "LArReco, unrecognised event file type: " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    if (m_eventReadingSettings.m_useLArCaloHits)
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=,
+            pFileReader->SetFactory(new CountingLArCaloHitFactory(m_eventReadingSettings.m_larCaloHitVersion, m_nHits)));
+
+    if (m_eventReadingSettings.m_useLArMCParticles)
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=,
+            pFileReader->SetFactory(new lar_content::LArMCParticleFactory(m_eventReadingSettings.m_larMCParticleVersion)));
+
+    return pFileReader.release();
+}
+
+} // namespace lar_reco
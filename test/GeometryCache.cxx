@@ -0,0 +1,332 @@
+/**
+ *  @file   LArReco/test/GeometryCache.cxx
+ *
+ *  @brief  Implementation of the geometry cache and the detector gap index
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Geometry/DetectorGap.h"
+#include "Persistency/BinaryFileWriter.h"
+#include "Persistency/XmlFileReader.h"
+
+#include "GeometryCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+using namespace pandora;
+
+namespace
+{
+
+const float BOUNDARY_TOLERANCE(1.e-3f);     ///< The margin by which gaps are widened when assigned to cells, covering rounding, cm
+const std::size_t MAX_N_CELLS(1 << 20);     ///< The maximum number of cells, beyond which a single cell lists every gap
+
+/**
+ *  @brief  Get the interval, between sorted boundaries, containing a coordinate
+ *
+ *  @param  boundaryList the sorted boundaries
+ *  @param  coordinate the coordinate
+ *  @param  iInterval to receive the interval index
+ *
+ *  @return whether the coordinate lies between the first and last boundaries
+ */
+bool GetInterval(const std::vector<float> &boundaryList, const float coordinate, unsigned int &iInterval)
+{
+    // ATTN Written so that a nan coordinate lies outside the boundaries
+    if (boundaryList.empty() || !(coordinate >= boundaryList.front()) || !(coordinate < boundaryList.back()))
+        return false;
+
+    iInterval = std::upper_bound(boundaryList.begin(), boundaryList.end(), coordinate) - boundaryList.begin() - 1;
+    return true;
+}
+
+/**
+ *  @brief  Get the range of intervals, between sorted boundaries, overlapping a range of coordinates
+ *
+ *  @param  boundaryList the sorted boundaries, at least two
+ *  @param  lower the lower end of the range of coordinates
+ *  @param  upper the upper end of the range of coordinates
+ *  @param  iFirstInterval to receive the index of the first overlapping interval
+ *  @param  iLastInterval to receive the index of the last overlapping interval
+ */
+void GetIntervalRange(const std::vector<float> &boundaryList, const float lower, const float upper, unsigned int &iFirstInterval,
+    unsigned int &iLastInterval)
+{
+    // The overlapping intervals are those ending above the lower end of the range and starting below its upper end
+    const unsigned int nIntervals(boundaryList.size() - 1);
+    const unsigned int nEndsBelow(std::upper_bound(boundaryList.begin() + 1, boundaryList.end(), lower) - (boundaryList.begin() + 1));
+    const unsigned int nStartsBelow(std::lower_bound(boundaryList.begin(), boundaryList.end() - 1, upper) - boundaryList.begin());
+
+    iFirstInterval = std::min(nEndsBelow, nIntervals - 1);
+    iLastInterval = std::max(nStartsBelow, 1u) - 1;
+}
+
+/**
+ *  @brief  Sort the boundaries along an axis and remove duplicates
+ *
+ *  @param  boundaryList the boundaries
+ *
+ *  @return the number of intervals between the boundaries, at least one
+ */
+std::size_t SortBoundaries(std::vector<float> &boundaryList)
+{
+    std::sort(boundaryList.begin(), boundaryList.end());
+    boundaryList.erase(std::unique(boundaryList.begin(), boundaryList.end()), boundaryList.end());
+
+    if (1 == boundaryList.size())
+        boundaryList.push_back(boundaryList.front());
+
+    return (boundaryList.size() - 1);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+GeometryCache::GeometryCache(const std::string &geometryFileName) :
+    m_geometryFileName(geometryFileName),
+    m_isXml((geometryFileName.size() >= 4) && (0 == geometryFileName.compare(geometryFileName.size() - 4, 4, ".xml")))
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string GeometryCache::GetGeometryFileName() const
+{
+    if (!m_isXml)
+        return m_geometryFileName;
+
+    if (this->IsUpToDate() || this->Write())
+        return GeometryCache::GetCacheFileName(m_geometryFileName);
+
+    std::cout << "LArReco, unable to write geometry cache " << GeometryCache::GetCacheFileName(m_geometryFileName) << ", reading "
+              << m_geometryFileName << std::endl;
+
+    return m_geometryFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool GeometryCache::IsUpToDate() const
+{
+    struct stat geometryFileStatus, cacheFileStatus;
+
+    return ((0 == ::stat(m_geometryFileName.c_str(), &geometryFileStatus)) &&
+        (0 == ::stat(GeometryCache::GetCacheFileName(m_geometryFileName).c_str(), &cacheFileStatus)) &&
+        (geometryFileStatus.st_mtime == cacheFileStatus.st_mtime));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool GeometryCache::Write() const
+{
+    struct stat geometryFileStatus;
+
+    if (0 != ::stat(m_geometryFileName.c_str(), &geometryFileStatus))
+        return false;
+
+    // ATTN The cache is written under a temporary name and then renamed, so that concurrent jobs never see a partial cache
+    const std::string cacheFileName(GeometryCache::GetCacheFileName(m_geometryFileName));
+    const std::string temporaryFileName(cacheFileName + "." + std::to_string(::getpid()));
+
+    try
+    {
+        // Reading and writing the geometry needs no algorithms or plugins, so a bare pandora instance suffices
+        const Pandora pandora;
+        XmlFileReader fileReader(pandora, m_geometryFileName);
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadGeometry());
+
+        BinaryFileWriter fileWriter(pandora, temporaryFileName, OVERWRITE);
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteGeometry());
+    }
+    catch (const StatusCodeException &)
+    {
+        std::remove(temporaryFileName.c_str());
+        return false;
+    }
+
+    // ATTN The cache takes the modification time of the xml, so that any later change to the xml marks the cache as stale
+    struct utimbuf cacheFileTimes;
+    cacheFileTimes.actime = geometryFileStatus.st_atime;
+    cacheFileTimes.modtime = geometryFileStatus.st_mtime;
+
+    if ((0 != ::utime(temporaryFileName.c_str(), &cacheFileTimes)) || (0 != std::rename(temporaryFileName.c_str(), cacheFileName.c_str())))
+    {
+        std::remove(temporaryFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DetectorGapIndex::DetectorGapIndex(const DetectorGapList &detectorGapList, const float gapTolerance) :
+    m_gapTolerance(gapTolerance)
+{
+    // The u, v and w views, then 3D
+    GapExtentList gapExtentListArray[4];
+    DetectorGapVector directGapVectorArray[4];
+
+    for (const DetectorGap *const pDetectorGap : detectorGapList)
+    {
+        m_allGapVector.push_back(pDetectorGap);
+        const LineGap *const pLineGap(dynamic_cast<const LineGap *>(pDetectorGap));
+
+        if (!pLineGap)
+        {
+            for (DetectorGapVector &directGapVector : directGapVectorArray)
+                directGapVector.push_back(pDetectorGap);
+
+            continue;
+        }
+
+        const float margin(std::fabs(gapTolerance) + BOUNDARY_TOLERANCE);
+        const GapExtent gapExtent{pDetectorGap, std::min(pLineGap->GetLineStartX(), pLineGap->GetLineEndX()) - margin,
+            std::max(pLineGap->GetLineStartX(), pLineGap->GetLineEndX()) + margin,
+            std::min(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ()) - margin,
+            std::max(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ()) + margin};
+        const LineGapType lineGapType(pLineGap->GetLineGapType());
+
+        if (TPC_DRIFT_GAP == lineGapType)
+        {
+            for (GapExtentList &gapExtentList : gapExtentListArray)
+                gapExtentList.push_back(gapExtent);
+        }
+        else if ((TPC_WIRE_GAP_VIEW_U == lineGapType) || (TPC_WIRE_GAP_VIEW_V == lineGapType) || (TPC_WIRE_GAP_VIEW_W == lineGapType))
+        {
+            const unsigned int iView((TPC_WIRE_GAP_VIEW_U == lineGapType) ? 0 : (TPC_WIRE_GAP_VIEW_V == lineGapType) ? 1 : 2);
+            gapExtentListArray[iView].push_back(gapExtent);
+            directGapVectorArray[3].push_back(pDetectorGap);
+        }
+        else
+        {
+            for (DetectorGapVector &directGapVector : directGapVectorArray)
+                directGapVector.push_back(pDetectorGap);
+        }
+    }
+
+    for (unsigned int iGrid = 0; iGrid < 4; ++iGrid)
+        m_gapGridList.emplace_back(gapExtentListArray[iGrid], directGapVectorArray[iGrid]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::IsInGap(const CartesianVector &position, const HitType hitType) const
+{
+    if (TPC_VIEW_U == hitType)
+        return m_gapGridList[0].IsInGap(position, hitType, m_gapTolerance);
+
+    if (TPC_VIEW_V == hitType)
+        return m_gapGridList[1].IsInGap(position, hitType, m_gapTolerance);
+
+    if (TPC_VIEW_W == hitType)
+        return m_gapGridList[2].IsInGap(position, hitType, m_gapTolerance);
+
+    if (TPC_3D == hitType)
+        return m_gapGridList[3].IsInGap(position, hitType, m_gapTolerance);
+
+    for (const DetectorGap *const pDetectorGap : m_allGapVector)
+    {
+        if (pDetectorGap->IsInGap(position, hitType, m_gapTolerance))
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DetectorGapIndex::GapGrid::GapGrid(const GapExtentList &gapExtentList, const DetectorGapVector &directGapVector) :
+    m_directGapVector(directGapVector)
+{
+    typedef std::vector<DetectorGapVector> CellList;
+
+    if (gapExtentList.empty())
+    {
+        m_cellOffsetList.push_back(0);
+        return;
+    }
+
+    for (const GapExtent &gapExtent : gapExtentList)
+    {
+        m_boundaryListX.push_back(gapExtent.m_minX);
+        m_boundaryListX.push_back(gapExtent.m_maxX);
+        m_boundaryListZ.push_back(gapExtent.m_minZ);
+        m_boundaryListZ.push_back(gapExtent.m_maxZ);
+    }
+
+    const unsigned int nIntervalsX(SortBoundaries(m_boundaryListX)), nIntervalsZ(SortBoundaries(m_boundaryListZ));
+
+    // ATTN Too fine a grid, from an unaligned arrangement of many gaps, is replaced by a single cell listing every gap
+    if (static_cast<std::size_t>(nIntervalsX) * nIntervalsZ > MAX_N_CELLS)
+    {
+        m_boundaryListX = BoundaryList{m_boundaryListX.front(), m_boundaryListX.back()};
+        m_boundaryListZ = BoundaryList{m_boundaryListZ.front(), m_boundaryListZ.back()};
+    }
+
+    const unsigned int nCellsZ(m_boundaryListZ.size() - 1);
+    CellList cellList((m_boundaryListX.size() - 1) * nCellsZ);
+
+    for (const GapExtent &gapExtent : gapExtentList)
+    {
+        unsigned int firstIntervalX(0), lastIntervalX(0), firstIntervalZ(0), lastIntervalZ(0);
+        GetIntervalRange(m_boundaryListX, gapExtent.m_minX, gapExtent.m_maxX, firstIntervalX, lastIntervalX);
+        GetIntervalRange(m_boundaryListZ, gapExtent.m_minZ, gapExtent.m_maxZ, firstIntervalZ, lastIntervalZ);
+
+        for (unsigned int iX = firstIntervalX; iX <= lastIntervalX; ++iX)
+        {
+            for (unsigned int iZ = firstIntervalZ; iZ <= lastIntervalZ; ++iZ)
+                cellList.at(iX * nCellsZ + iZ).push_back(gapExtent.m_pDetectorGap);
+        }
+    }
+
+    for (const DetectorGapVector &cellGapList : cellList)
+    {
+        m_cellOffsetList.push_back(m_cellGapList.size());
+        m_cellGapList.insert(m_cellGapList.end(), cellGapList.begin(), cellGapList.end());
+    }
+
+    m_cellOffsetList.push_back(m_cellGapList.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::GapGrid::IsInGap(const CartesianVector &position, const HitType hitType, const float gapTolerance) const
+{
+    for (const DetectorGap *const pDetectorGap : m_directGapVector)
+    {
+        if (pDetectorGap->IsInGap(position, hitType, gapTolerance))
+            return true;
+    }
+
+    unsigned int iX(0), iZ(0);
+
+    if (!GetInterval(m_boundaryListX, position.GetX(), iX) || !GetInterval(m_boundaryListZ, position.GetZ(), iZ))
+        return false;
+
+    const unsigned int iCell(iX * (m_boundaryListZ.size() - 1) + iZ);
+
+    for (unsigned int iEntry = m_cellOffsetList[iCell]; iEntry < m_cellOffsetList[iCell + 1]; ++iEntry)
+    {
+        if (m_cellGapList[iEntry]->IsInGap(position, hitType, gapTolerance))
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace lar_reco
@@ -0,0 +1,389 @@
+/**
+ *  @file   LArReco/test/MemoryMonitor.cxx
+ *
+ *  @brief  Implementation of the memory monitor and event memory releaser classes, and of the counting global operator new, which is
+ *          only built with ALLOCATION_COUNTING.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "EventReading.h"
+#include "MemoryMonitor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace pandora;
+
+namespace
+{
+
+#ifdef ALLOCATION_COUNTING
+const bool isCountingAllocations(true);                         ///< Whether allocations are counted by the global operator new
+
+thread_local unsigned long long threadAllocationCount(0);       ///< The number of allocations made by the thread
+thread_local unsigned long long threadAllocatedBytes(0);        ///< The total size of the allocations made by the thread
+thread_local unsigned long long threadEventAllocationCount(0);  ///< The thread allocation count at the start of the current event
+thread_local unsigned long long threadEventAllocatedBytes(0);   ///< The thread allocated bytes at the start of the current event
+#else
+const bool isCountingAllocations(false);                        ///< Whether allocations are counted by the global operator new
+#endif
+
+/**
+ *  @brief  Get a percentile of a list of values, using the nearest-rank method
+ *
+ *  @param  sortedValues the values, in ascending order
+ *  @param  percentile the percentile
+ *
+ *  @return the value at the percentile
+ */
+template <typename T>
+T GetPercentile(const std::vector<T> &sortedValues, const double percentile)
+{
+    if (sortedValues.empty())
+        return T(0);
+
+    const std::size_t rank(static_cast<std::size_t>(percentile / 100. * sortedValues.size() + 0.999999));
+    return sortedValues.at(std::min(std::max(rank, std::size_t(1)), sortedValues.size()) - 1);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef ALLOCATION_COUNTING
+// ATTN Replacing the global operator new affects every allocation in the process, so is only built when allocations are to be counted
+void *operator new(std::size_t size)
+{
+    ++threadAllocationCount;
+    threadAllocatedBytes += size;
+
+    while (true)
+    {
+        void *const pMemory(std::malloc((size > 0) ? size : 1));
+
+        if (pMemory)
+            return pMemory;
+
+        const std::new_handler newHandler(std::get_new_handler());
+
+        if (!newHandler)
+            throw std::bad_alloc();
+
+        newHandler();
+    }
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return ::operator new(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, const std::nothrow_t &) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, const std::nothrow_t &) noexcept
+{
+    std::free(pMemory);
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+MemoryMonitor::MemoryMonitor(const std::string &outputFileName) :
+    m_outputFileName(outputFileName),
+    m_outputFile(outputFileName, std::ios::trunc),
+    m_nEventsInProgress(0),
+    m_canResetPeakRss(true)
+{
+    if (!m_outputFile.is_open())
+    {
+        std::cout << "LArReco, unable to open memory file " << outputFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    m_outputFile << "fileName,eventNumber,peakRssKB" << (isCountingAllocations ? ",allocations,allocatedBytes" : "") << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+MemoryMonitor::~MemoryMonitor()
+{
+    m_outputFile.close();
+    this->WriteSummary();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MemoryMonitor::EventStarted(const EventId &)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // ATTN The high-water mark belongs to the process, so is not reset beneath an event being processed by another thread
+        if ((0 == m_nEventsInProgress++) && m_canResetPeakRss && !MemoryMonitor::ResetPeakRss())
+        {
+            std::cout << "LArReco, unable to reset peak resident memory, per-event values will show the job high-water mark" << std::endl;
+            m_canResetPeakRss = false;
+        }
+    }
+
+#ifdef ALLOCATION_COUNTING
+    threadEventAllocationCount = threadAllocationCount;
+    threadEventAllocatedBytes = threadAllocatedBytes;
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MemoryMonitor::EventProcessed(const EventId &eventId, const double, const double)
+{
+    EventMemory eventMemory;
+    eventMemory.m_fileName = eventId.m_fileName;
+    eventMemory.m_eventNumber = eventId.m_eventNumber;
+    eventMemory.m_peakRssKB = MemoryMonitor::GetPeakRss();
+#ifdef ALLOCATION_COUNTING
+    eventMemory.m_nAllocations = threadAllocationCount - threadEventAllocationCount;
+    eventMemory.m_allocatedBytes = threadAllocatedBytes - threadEventAllocatedBytes;
+#else
+    eventMemory.m_nAllocations = 0;
+    eventMemory.m_allocatedBytes = 0;
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_nEventsInProgress > 0)
+        --m_nEventsInProgress;
+
+    m_outputFile << eventMemory.m_fileName << "," << eventMemory.m_eventNumber << "," << eventMemory.m_peakRssKB;
+
+    if (isCountingAllocations)
+        m_outputFile << "," << eventMemory.m_nAllocations << "," << eventMemory.m_allocatedBytes;
+
+    m_outputFile << std::endl;
+    m_eventMemoryList.push_back(eventMemory);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool MemoryMonitor::ResetPeakRss()
+{
+    // Writing 5 to clear_refs resets the VmHWM high-water mark, on Linux 4.0 and later
+    std::ofstream clearRefsFile("/proc/self/clear_refs");
+
+    if (!clearRefsFile.is_open())
+        return false;
+
+    clearRefsFile << "5" << std::flush;
+    return static_cast<bool>(clearRefsFile);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+long long MemoryMonitor::GetPeakRss()
+{
+    std::ifstream statusFile("/proc/self/status");
+    std::string line;
+
+    while (std::getline(statusFile, line))
+    {
+        if (0 != line.compare(0, 6, "VmHWM:"))
+            continue;
+
+        long long peakRssKB(-1);
+        std::istringstream(line.substr(6)) >> peakRssKB;
+        return peakRssKB;
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MemoryMonitor::WriteSummary() const
+{
+    std::vector<long long> peakRssList;
+    std::vector<unsigned long long> nAllocationsList, allocatedBytesList;
+
+    for (const EventMemory &eventMemory : m_eventMemoryList)
+    {
+        peakRssList.push_back(eventMemory.m_peakRssKB);
+        nAllocationsList.push_back(eventMemory.m_nAllocations);
+        allocatedBytesList.push_back(eventMemory.m_allocatedBytes);
+    }
+
+    std::sort(peakRssList.begin(), peakRssList.end());
+    std::sort(nAllocationsList.begin(), nAllocationsList.end());
+    std::sort(allocatedBytesList.begin(), allocatedBytesList.end());
+
+    const std::string::size_type extensionPosition(m_outputFileName.find_last_of('.'));
+    const std::string::size_type separatorPosition(m_outputFileName.find_last_of('/'));
+    const bool hasExtension(
+        (std::string::npos != extensionPosition) && ((std::string::npos == separatorPosition) || (extensionPosition > separatorPosition)));
+    const std::string summaryFileName(hasExtension ? m_outputFileName.substr(0, extensionPosition) + "_Summary" + m_outputFileName.substr(extensionPosition)
+                                                   : m_outputFileName + "_Summary");
+
+    const std::vector<double> percentiles{50., 90., 95., 99., 100.};
+    std::ofstream summaryFile(summaryFileName, std::ios::trunc);
+    summaryFile << "percentile,peakRssKB" << (isCountingAllocations ? ",allocations,allocatedBytes" : "") << std::endl;
+
+    std::cout << std::endl
+              << "LArReco, memory usage over " << m_eventMemoryList.size() << " events, written to " << m_outputFileName << " and "
+              << summaryFileName << std::endl
+              << "    " << std::left << std::setw(12) << "percentile" << std::right << std::setw(16) << "peakRssMB";
+
+    if (isCountingAllocations)
+        std::cout << std::setw(16) << "allocations" << std::setw(16) << "allocatedMB";
+
+    std::cout << std::endl;
+
+    for (const double percentile : percentiles)
+    {
+        const long long peakRssKB(GetPercentile(peakRssList, percentile));
+        const unsigned long long nAllocations(GetPercentile(nAllocationsList, percentile));
+        const unsigned long long allocatedBytes(GetPercentile(allocatedBytesList, percentile));
+
+        summaryFile << percentile << "," << peakRssKB;
+        std::cout << "    " << std::left << std::setw(12) << ("p" + std::to_string(static_cast<int>(percentile))) << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(16) << (peakRssKB / 1024.);
+
+        if (isCountingAllocations)
+        {
+            summaryFile << "," << nAllocations << "," << allocatedBytes;
+            std::cout << std::setw(16) << nAllocations << std::setw(16) << (allocatedBytes / (1024. * 1024.));
+        }
+
+        summaryFile << std::endl;
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    EventMemoryList largestEventList(m_eventMemoryList);
+    std::sort(largestEventList.begin(), largestEventList.end(),
+        [](const EventMemory &lhs, const EventMemory &rhs) { return (lhs.m_peakRssKB > rhs.m_peakRssKB); });
+
+    const std::size_t nEventsToPrint(std::min(largestEventList.size(), std::size_t(5)));
+
+    if (nEventsToPrint > 0)
+        std::cout << "    Largest peak resident memory:" << std::endl;
+
+    for (std::size_t iEvent = 0; iEvent < nEventsToPrint; ++iEvent)
+    {
+        const EventMemory &eventMemory(largestEventList.at(iEvent));
+        std::cout << "    " << std::fixed << std::setprecision(1) << std::setw(10) << (eventMemory.m_peakRssKB / 1024.) << " MB  event "
+                  << eventMemory.m_eventNumber << " (" << eventMemory.m_fileName << ")" << std::defaultfloat << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventMemoryReleaser::EventMemoryReleaser(
+    const unsigned int rssThresholdMB, const unsigned int nEventsPerRelease, const unsigned int mmapThresholdKB) :
+    m_rssThresholdKB(1024LL * rssThresholdMB),
+    m_nEventsPerRelease(nEventsPerRelease),
+    m_nEventsSinceRelease(0)
+{
+#ifdef __GLIBC__
+    // ATTN Setting the threshold explicitly disables its dynamic growth, which otherwise moves ever larger buffers into the heap arenas
+    if ((mmapThresholdKB > 0) && (1 != ::mallopt(M_MMAP_THRESHOLD, 1024 * mmapThresholdKB)))
+        std::cout << "LArReco, unable to set allocator mmap threshold" << std::endl;
+#else
+    (void)mmapThresholdKB;
+    std::cout << "LArReco, event memory release is not supported by this allocator, and will have no effect" << std::endl;
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventMemoryReleaser::EventProcessed(const EventId &, const double, const double)
+{
+#ifdef __GLIBC__
+    const bool isEventCountReached((m_nEventsPerRelease > 0) && (++m_nEventsSinceRelease >= m_nEventsPerRelease));
+
+    if (!isEventCountReached && ((0 == m_rssThresholdKB) || (EventMemoryReleaser::GetRss() <= m_rssThresholdKB)))
+        return;
+
+    // ATTN A thread finding a release already under way leaves it to cover the memory freed by its own event
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+
+    if (!lock.owns_lock())
+        return;
+
+    m_nEventsSinceRelease = 0;
+    ::malloc_trim(0);
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+long long EventMemoryReleaser::GetRss()
+{
+    std::ifstream statusFile("/proc/self/status");
+    std::string line;
+
+    while (std::getline(statusFile, line))
+    {
+        if (0 != line.compare(0, 6, "VmRSS:"))
+            continue;
+
+        long long rssKB(-1);
+        std::istringstream(line.substr(6)) >> rssKB;
+        return rssKB;
+    }
+
+    return -1;
+}
+
+} // namespace lar_reco
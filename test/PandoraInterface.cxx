@@ -13,6 +13,7 @@
 #include "larpandoracontent/LArContent.h"
 #include "larpandoracontent/LArControlFlow/MasterAlgorithm.h"
 #include "larpandoracontent/LArControlFlow/MultiPandoraApi.h"
+#include "larpandoracontent/LArHelpers/LArFileHelper.h"
 #include "larpandoracontent/LArHelpers/LArPfoHelper.h"
 #include "larpandoracontent/LArPersistency/EventReadingAlgorithm.h"
 #include "larpandoracontent/LArPlugins/LArPseudoLayerPlugin.h"
@@ -20,17 +21,41 @@
 
 #ifdef LIBTORCH_DL
 #include "larpandoradlcontent/LArDLContent.h"
+
+#include <ATen/Parallel.h>
 #endif
 
+#include "AlgorithmTiming.h"
+#include "EventDaemon.h"
+#include "EventIndex.h"
+#include "EventPrefetching.h"
+#include "EventReading.h"
+#include "GeometryCache.h"
+#include "MemoryMonitor.h"
 #include "PandoraInterface.h"
+#include "SettingsSnapshot.h"
+#include "SocketHelper.h"
+#include "WorkDistribution.h"
 
 #ifdef MONITORING
 #include "TApplication.h"
+#include "TROOT.h"
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
 #include <getopt.h>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace pandora;
 using namespace lar_reco;
@@ -38,7 +63,7 @@ using namespace lar_reco;
 int main(int argc, char *argv[])
 {
     int errorNo(0);
-    const Pandora *pPrimaryPandora(nullptr);
+    PrimaryPandoraList primaryPandoraList;
 
     try
     {
@@ -47,16 +72,116 @@ int main(int argc, char *argv[])
         if (!ParseCommandLine(argc, argv, parameters))
             return 1;
 
+        if (!parameters.m_daemonClientAddress.empty())
+        {
+            return (EventDaemon::SubmitRequest(parameters.m_daemonClientAddress, parameters.m_eventFileNameList,
+                        parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0, parameters.m_nEventsToProcess)
+                    ? 0
+                    : 1);
+        }
+
+        // ATTN Every instance has the same settings, so files written by several instances would share a name, clobbering one another
+        if (((parameters.m_nThreads > 1) || (parameters.m_nEventsToPrefetch > 0)) && IsFileOutputConfigured(parameters.m_settingsFile))
+        {
+            std::cout << "LArReco, algorithms writing files require a single pandora instance, so cannot be combined with -t or -P" << std::endl;
+            return 1;
+        }
+
+        if (!parameters.m_timingFileName.empty())
+        {
+            // Algorithm timing relies upon the markers placed in an instrumented snapshot of the settings
+            parameters.m_settingsFile = SettingsSnapshot(parameters.m_settingsFile, "LArRecoTimingSettings").GetSettingsFile();
+        }
+
+        // Each pandora instance, in each worker, reads the geometry, so an xml description is converted once to a binary cache
+        if (!parameters.m_geometryFileName.empty())
+            parameters.m_geometryFileName = GeometryCache(parameters.m_geometryFileName).GetGeometryFileName();
+
+        if (!parameters.m_coordinatorAddress.empty() && RunCoordinator(parameters))
+            return 0;
+
 #ifdef MONITORING
         TApplication *pTApplication = new TApplication("LArReco", &argc, argv);
         pTApplication->SetReturnFromRun(kTRUE);
+
+        if (parameters.m_nThreads > 1)
+            ROOT::EnableThreadSafety();
 #endif
-        CreatePandoraInstances(parameters, pPrimaryPandora);
+        std::unique_ptr<AlgorithmTimingRecorder> pAlgorithmTimingRecorder(
+            parameters.m_timingFileName.empty() ? nullptr : new AlgorithmTimingRecorder(parameters.m_timingFileName));
+        std::unique_ptr<InferenceTimingRecorder> pInferenceTimingRecorder(
+            parameters.m_inferenceFileName.empty() ? nullptr : new InferenceTimingRecorder(parameters.m_inferenceFileName));
+        std::unique_ptr<MemoryMonitor> pMemoryMonitor(parameters.m_memoryFileName.empty() ? nullptr : new MemoryMonitor(parameters.m_memoryFileName));
 
-        if (!pPrimaryPandora)
-            throw StatusCodeException(STATUS_CODE_FAILURE);
+        EventObserverList eventObserverList;
+
+        if (pAlgorithmTimingRecorder)
+            eventObserverList.AddObserver(pAlgorithmTimingRecorder.get());
+
+        if (pInferenceTimingRecorder)
+            eventObserverList.AddObserver(pInferenceTimingRecorder.get());
+
+        if (pMemoryMonitor)
+            eventObserverList.AddObserver(pMemoryMonitor.get());
 
-        ProcessEvents(parameters, pPrimaryPandora);
+        // ATTN The release follows the other observers, so that its cost is not attributed to the event
+        std::unique_ptr<EventMemoryReleaser> pEventMemoryReleaser(parameters.m_shouldReleaseEventMemory
+                ? new EventMemoryReleaser(parameters.m_releaseRssThresholdMB, parameters.m_nEventsPerRelease, parameters.m_mmapThresholdKB)
+                : nullptr);
+
+        if (pEventMemoryReleaser)
+            eventObserverList.AddObserver(pEventMemoryReleaser.get());
+
+        EventObserver *const pEventObserver(eventObserverList.IsEmpty() ? nullptr : &eventObserverList);
+
+        if (parameters.m_shouldIndexEventFiles)
+        {
+            CreatePandoraInstances(parameters, primaryPandoraList);
+            IndexEventFiles(parameters, primaryPandoraList.front());
+        }
+        else if (!parameters.m_workerAddress.empty())
+        {
+            RemoteEventQueue eventQueue(parameters.m_workerAddress);
+            CreatePandoraInstances(parameters, primaryPandoraList);
+            ProcessEventsConcurrently(parameters, primaryPandoraList, eventQueue, pEventObserver);
+
+            // ATTN Output files are only complete once the pandora instances have been deleted
+            for (const Pandora *const pPrimaryPandora : primaryPandoraList)
+                MultiPandoraApi::DeletePandoraInstances(pPrimaryPandora);
+
+            primaryPandoraList.clear();
+            eventQueue.SendOutputFiles();
+        }
+        else if (!parameters.m_daemonAddress.empty())
+        {
+            CreatePandoraInstances(parameters, primaryPandoraList);
+            EventDaemon(parameters, primaryPandoraList).Run();
+        }
+        else if (!parameters.m_eventListFileName.empty())
+        {
+            EventListQueue eventQueue(parameters.m_eventListFileName, parameters.m_eventFileNameList,
+                parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0, parameters.m_nEventsToProcess);
+            CreatePandoraInstances(parameters, primaryPandoraList);
+            ProcessEventsConcurrently(parameters, primaryPandoraList, eventQueue, pEventObserver);
+        }
+        else if ((parameters.m_nThreads > 1) || (parameters.m_nEventsToPrefetch > 0) || pEventObserver)
+        {
+            // ATTN Prefetching, timing and memory handling need the application to read events, so a single-threaded job also uses the queue
+            FileListEventQueue eventQueue(parameters.m_eventFileNameList,
+                parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0, parameters.m_nEventsToProcess);
+            CreatePandoraInstances(parameters, primaryPandoraList);
+            ProcessEventsConcurrently(parameters, primaryPandoraList, eventQueue, pEventObserver);
+        }
+        else
+        {
+            primaryPandoraList.push_back(nullptr);
+            CreatePandoraInstances(parameters, primaryPandoraList.back());
+
+            if (!primaryPandoraList.back())
+                throw StatusCodeException(STATUS_CODE_FAILURE);
+
+            ProcessEvents(parameters, primaryPandoraList.back());
+        }
     }
     catch (const StatusCodeException &statusCodeException)
     {
@@ -74,7 +199,9 @@ int main(int argc, char *argv[])
         errorNo = 1;
     }
 
-    MultiPandoraApi::DeletePandoraInstances(pPrimaryPandora);
+    for (const Pandora *const pPrimaryPandora : primaryPandoraList)
+        MultiPandoraApi::DeletePandoraInstances(pPrimaryPandora);
+
     return errorNo;
 }
 
@@ -92,6 +219,9 @@ void CreatePandoraInstances(const Parameters &parameters, const Pandora *&pPrima
 #endif
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArContent::RegisterBasicPlugins(*pPrimaryPandora));
 
+    if (!parameters.m_timingFileName.empty())
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, AlgorithmTimingRecorder::RegisterAlgorithms(*pPrimaryPandora));
+
     if (!pPrimaryPandora)
         throw StatusCodeException(STATUS_CODE_FAILURE);
 
@@ -106,6 +236,25 @@ void CreatePandoraInstances(const Parameters &parameters, const Pandora *&pPrima
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+void CreatePandoraInstances(const Parameters &parameters, PrimaryPandoraList &primaryPandoraList)
+{
+    // ATTN LArEventReading is left to read the geometry only, with events read by the application and placed in each primary instance
+    Parameters instanceParameters(parameters);
+    instanceParameters.m_eventFileNameList.clear();
+    instanceParameters.m_nEventsToSkip = InputInt();
+
+    for (int iInstance = 0; iInstance < parameters.m_nThreads + parameters.m_nEventsToPrefetch; ++iInstance)
+    {
+        primaryPandoraList.push_back(nullptr);
+        CreatePandoraInstances(instanceParameters, primaryPandoraList.back());
+
+        if (!primaryPandoraList.back())
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 void ProcessEvents(const Parameters &parameters, const Pandora *const pPrimaryPandora)
 {
     int nEvents(0);
@@ -122,6 +271,376 @@ void ProcessEvents(const Parameters &parameters, const Pandora *const pPrimaryPa
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+void ProcessEventsConcurrently(const Parameters &parameters, const PrimaryPandoraList &primaryPandoraList, EventQueue &eventQueue,
+    EventObserver *const pEventObserver)
+{
+    EventReadingSettings eventReadingSettings;
+    ReadEventReadingSettings(parameters.m_settingsFile, eventReadingSettings);
+
+    // ATTN When prefetching, the instances beyond one per thread hold the events read ahead, which are handed to whichever thread is free
+    std::unique_ptr<EventPrefetcher> pEventPrefetcher(
+        (parameters.m_nEventsToPrefetch > 0) ? new EventPrefetcher(primaryPandoraList, eventReadingSettings, eventQueue) : nullptr);
+    const unsigned int nThreads(pEventPrefetcher ? std::min<unsigned int>(parameters.m_nThreads, primaryPandoraList.size()) : primaryPandoraList.size());
+
+    std::vector<std::thread> threadVector;
+    std::vector<std::exception_ptr> exceptionVector(nThreads);
+
+    for (unsigned int iThread = 0; iThread < nThreads; ++iThread)
+    {
+        threadVector.emplace_back(
+            [&, iThread]()
+            {
+                try
+                {
+                    if (pEventPrefetcher)
+                    {
+                        ProcessPrefetchedEvents(parameters, *pEventPrefetcher, pEventObserver);
+                    }
+                    else
+                    {
+                        ProcessQueuedEvents(parameters, eventReadingSettings, primaryPandoraList.at(iThread), eventQueue, pEventObserver);
+                    }
+                }
+                catch (const StopProcessingException &)
+                {
+                    eventQueue.Abort();
+
+                    if (pEventPrefetcher)
+                        pEventPrefetcher->Abort();
+                }
+                catch (...)
+                {
+                    exceptionVector.at(iThread) = std::current_exception();
+                    eventQueue.Abort();
+
+                    if (pEventPrefetcher)
+                        pEventPrefetcher->Abort();
+                }
+            });
+    }
+
+    for (std::thread &thread : threadVector)
+        thread.join();
+
+    for (const std::exception_ptr &pException : exceptionVector)
+    {
+        if (pException)
+            std::rethrow_exception(pException);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProcessQueuedEvents(const Parameters &parameters, const EventReadingSettings &eventReadingSettings, const Pandora *const pPrimaryPandora,
+    EventQueue &eventQueue, EventObserver *const pEventObserver)
+{
+    static std::mutex displayMutex;
+
+    EventReader eventReader(*pPrimaryPandora, eventReadingSettings);
+    EventId eventId;
+
+    while (eventQueue.GetNextEvent(eventId))
+    {
+        const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+        if (STATUS_CODE_SUCCESS != eventReader.ReadEvent(eventId))
+        {
+            eventQueue.SetEndOfFile(eventId);
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+            continue;
+        }
+
+        if (parameters.m_shouldDisplayEventNumber)
+        {
+            std::lock_guard<std::mutex> lock(displayMutex);
+            std::cout << std::endl << "   PROCESSING EVENT: " << eventId.m_eventNumber << " (" << eventId.m_fileName << ")" << std::endl << std::endl;
+        }
+
+        if (pEventObserver)
+            pEventObserver->EventStarted(eventId);
+
+        const std::chrono::steady_clock::time_point readTime(std::chrono::steady_clock::now());
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::ProcessEvent(*pPrimaryPandora));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+        eventQueue.SetEventProcessed(eventId);
+
+        if (pEventObserver)
+        {
+            const std::chrono::steady_clock::time_point endTime(std::chrono::steady_clock::now());
+            pEventObserver->EventProcessed(eventId, std::chrono::duration<double>(readTime - startTime).count(),
+                std::chrono::duration<double>(endTime - readTime).count());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProcessPrefetchedEvents(const Parameters &parameters, EventPrefetcher &eventPrefetcher, EventObserver *const pEventObserver)
+{
+    static std::mutex displayMutex;
+
+    const Pandora *pPrimaryPandora(nullptr);
+    EventId eventId;
+
+    while (true)
+    {
+        // ATTN The reported read time is the time spent waiting for the event, i.e. the read latency not hidden behind reconstruction
+        const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+        if (!eventPrefetcher.GetNextEvent(pPrimaryPandora, eventId))
+            break;
+
+        if (parameters.m_shouldDisplayEventNumber)
+        {
+            std::lock_guard<std::mutex> lock(displayMutex);
+            std::cout << std::endl << "   PROCESSING EVENT: " << eventId.m_eventNumber << " (" << eventId.m_fileName << ")" << std::endl << std::endl;
+        }
+
+        if (pEventObserver)
+            pEventObserver->EventStarted(eventId);
+
+        const std::chrono::steady_clock::time_point readTime(std::chrono::steady_clock::now());
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::ProcessEvent(*pPrimaryPandora));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+        eventPrefetcher.ReleaseEvent(pPrimaryPandora, eventId);
+
+        if (pEventObserver)
+        {
+            const std::chrono::steady_clock::time_point endTime(std::chrono::steady_clock::now());
+            pEventObserver->EventProcessed(eventId, std::chrono::duration<double>(readTime - startTime).count(),
+                std::chrono::duration<double>(endTime - readTime).count());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventObserverList::EventStarted(const EventId &eventId)
+{
+    for (EventObserver *const pEventObserver : m_observerList)
+        pEventObserver->EventStarted(eventId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventObserverList::EventProcessed(const EventId &eventId, const double readTime, const double processTime)
+{
+    for (EventObserver *const pEventObserver : m_observerList)
+        pEventObserver->EventProcessed(eventId, readTime, processTime);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void IndexEventFiles(const Parameters &parameters, const Pandora *const pPrimaryPandora)
+{
+    EventReadingSettings eventReadingSettings;
+    ReadEventReadingSettings(parameters.m_settingsFile, eventReadingSettings);
+
+    if (!eventReadingSettings.m_useLArCaloHits)
+    {
+        std::cout << "LArReco, event indices record lar calo hit counts, so require UseLArCaloHits in the LArEventReading settings" << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    StringVector eventFileNameVector;
+    XmlHelper::TokenizeString(parameters.m_eventFileNameList, eventFileNameVector, ":");
+
+    EventReader eventReader(*pPrimaryPandora, eventReadingSettings);
+
+    for (const std::string &eventFileName : eventFileNameVector)
+    {
+        EventIndex eventIndex;
+
+        if (!EventIndex::IsIndexable(eventFileName))
+        {
+            std::cout << "LArReco, only pndr files are indexed, skipping " << eventFileName << std::endl;
+            continue;
+        }
+
+        if (!eventIndex.Read(eventFileName))
+        {
+            // ATTN The index is written by the event reader, via the index builder, once every event in the file has been read
+            unsigned int eventNumber(0);
+
+            while (STATUS_CODE_SUCCESS == eventReader.ReadEvent(EventId(eventFileName, eventNumber++)))
+                PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+
+            if (!eventIndex.Read(eventFileName))
+            {
+                std::cout << "LArReco, unable to index event file " << eventFileName << std::endl;
+                throw StatusCodeException(STATUS_CODE_FAILURE);
+            }
+        }
+
+        std::cout << "LArReco, " << EventIndex::GetIndexFileName(eventFileName) << ": " << eventIndex.GetNEvents() << " events" << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool RunCoordinator(Parameters &parameters)
+{
+    const std::string workerAddress(SocketHelper::GetAbsoluteAddress(parameters.m_coordinatorAddress));
+
+    for (int iWorker = 0; iWorker < parameters.m_nLocalWorkers; ++iWorker)
+    {
+        const pid_t pid(::fork());
+
+        if (pid < 0)
+        {
+            std::cout << "LArReco, unable to start local worker " << iWorker << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        if (0 == pid)
+        {
+            parameters.m_workerAddress = workerAddress;
+            ConfigureLocalWorker(iWorker, parameters);
+            return false;
+        }
+    }
+
+    // ATTN Event file names are made absolute, so that they can be opened from the working directory of each worker
+    StringVector eventFileNameVector;
+    XmlHelper::TokenizeString(parameters.m_eventFileNameList, eventFileNameVector, ":");
+
+    std::string eventFileNameList;
+
+    for (const std::string &eventFileName : eventFileNameVector)
+        eventFileNameList += (eventFileNameList.empty() ? "" : ":") + GetAbsolutePath(eventFileName);
+
+    WorkCoordinator workCoordinator(parameters.m_coordinatorAddress, eventFileNameList,
+        parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0, parameters.m_nEventsToProcess,
+        parameters.m_nEventsPerWorkUnit, parameters.m_outputFileNameList);
+
+    const bool isComplete(workCoordinator.Run(parameters.m_nLocalWorkers));
+    workCoordinator.MergeOutputFiles();
+
+    if (!isComplete)
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ConfigureLocalWorker(const unsigned int workerIndex, Parameters &parameters)
+{
+    // ATTN Relative paths must be resolved before leaving the original working directory
+    parameters.m_settingsFile = GetAbsolutePath(parameters.m_settingsFile);
+
+    if (!parameters.m_geometryFileName.empty())
+        parameters.m_geometryFileName = GetAbsolutePath(parameters.m_geometryFileName);
+
+    parameters.m_coordinatorAddress.clear();
+    parameters.m_eventFileNameList.clear();
+
+    // Settings and model files located via FW_SEARCH_PATH, or relative to the original working directory, must remain visible
+    const char *const pSearchPath(std::getenv("FW_SEARCH_PATH"));
+    StringVector searchPathVector;
+
+    if (pSearchPath)
+        XmlHelper::TokenizeString(pSearchPath, searchPathVector, ":");
+
+    searchPathVector.push_back(".");
+    std::string searchPath;
+
+    for (const std::string &searchPathEntry : searchPathVector)
+        searchPath += (searchPath.empty() ? "" : ":") + GetAbsolutePath(searchPathEntry);
+
+    ::setenv("FW_SEARCH_PATH", searchPath.c_str(), 1);
+
+    const std::string workingDirectory("LArRecoWorker_" + std::to_string(workerIndex));
+
+    if (((0 != ::mkdir(workingDirectory.c_str(), 0755)) && (EEXIST != errno)) || (0 != ::chdir(workingDirectory.c_str())))
+    {
+        std::cout << "LArReco, unable to enter working directory " << workingDirectory << " for local worker" << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string GetAbsolutePath(const std::string &path)
+{
+    if (!path.empty() && ('/' == path[0]))
+        return path;
+
+    char workingDirectory[4096];
+
+    if (!::getcwd(workingDirectory, sizeof(workingDirectory)))
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    return (("." == path) ? std::string(workingDirectory) : std::string(workingDirectory) + "/" + path);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool IsFileOutputConfigured(const std::string &settingsFile)
+{
+    TiXmlDocument xmlDocument(settingsFile);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "LArReco, unable to load settings file " << settingsFile << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    const TiXmlHandle xmlDocumentHandle(&xmlDocument);
+    std::vector<TiXmlElement *> parentElementVector{xmlDocumentHandle.FirstChildElement().Element()};
+
+    // The switches with which algorithms and tools write trees, event and geometry files, and training samples, all off by default
+    const std::vector<std::string> fileOutputSwitchVector{
+        "WriteToTree", "WriteTree", "ShouldWriteEvents", "ShouldWriteGeometry", "TrainingMode", "UseTrainingMode", "TrainingSetMode"};
+
+    // Algorithms and tools are searched at every depth, with the settings files named by a master algorithm searched as the master would find them
+    while (!parentElementVector.empty())
+    {
+        TiXmlElement *const pParentElement(parentElementVector.back());
+        parentElementVector.pop_back();
+
+        if (!pParentElement)
+            continue;
+
+        for (TiXmlElement *pXmlElement = pParentElement->FirstChildElement(); nullptr != pXmlElement; pXmlElement = pXmlElement->NextSiblingElement())
+        {
+            parentElementVector.push_back(pXmlElement);
+
+            const std::string elementName(pXmlElement->Value());
+
+            if (("algorithm" != elementName) && ("tool" != elementName))
+                continue;
+
+            for (const std::string &fileOutputSwitch : fileOutputSwitchVector)
+            {
+                bool isFileOutputEnabled(false);
+                PANDORA_THROW_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=,
+                    XmlHelper::ReadValue(TiXmlHandle(pXmlElement), fileOutputSwitch, isFileOutputEnabled));
+
+                if (isFileOutputEnabled)
+                    return true;
+            }
+
+            for (const char *const pSettingsFileTag : {"CRSettingsFile", "NuSettingsFile", "SlicingSettingsFile"})
+            {
+                const TiXmlElement *const pFileElement(pXmlElement->FirstChildElement(pSettingsFileTag));
+
+                if (pFileElement && pFileElement->GetText() &&
+                    IsFileOutputConfigured(lar_content::LArFileHelper::FindFileInPath(pFileElement->GetText(), "FW_SEARCH_PATH")))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
 {
     if (1 == argc)
@@ -130,7 +649,7 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
     int c(0);
     std::string recoOption;
 
-    while ((c = getopt(argc, argv, "r:i:e:g:n:s:pNh")) != -1)
+    while ((c = getopt(argc, argv, "r:i:e:E:g:n:s:t:P:j:J:C:W:w:u:m:D:q:T:I:M:AR:K:L:xpNh")) != -1)
     {
         switch (c)
         {
@@ -143,6 +662,9 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
             case 'e':
                 parameters.m_eventFileNameList = optarg;
                 break;
+            case 'E':
+                parameters.m_eventListFileName = optarg;
+                break;
             case 'g':
                 parameters.m_geometryFileName = optarg;
                 break;
@@ -152,6 +674,63 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
             case 's':
                 parameters.m_nEventsToSkip = atoi(optarg);
                 break;
+            case 't':
+                parameters.m_nThreads = atoi(optarg);
+                break;
+            case 'P':
+                parameters.m_nEventsToPrefetch = atoi(optarg);
+                break;
+            case 'j':
+                parameters.m_nTorchThreads = atoi(optarg);
+                break;
+            case 'J':
+                parameters.m_nTorchInteropThreads = atoi(optarg);
+                break;
+            case 'C':
+                parameters.m_coordinatorAddress = optarg;
+                break;
+            case 'W':
+                parameters.m_workerAddress = optarg;
+                break;
+            case 'w':
+                parameters.m_nLocalWorkers = atoi(optarg);
+                break;
+            case 'u':
+                parameters.m_nEventsPerWorkUnit = atoi(optarg);
+                break;
+            case 'm':
+                parameters.m_outputFileNameList = optarg;
+                break;
+            case 'D':
+                parameters.m_daemonAddress = optarg;
+                break;
+            case 'q':
+                parameters.m_daemonClientAddress = optarg;
+                break;
+            case 'T':
+                parameters.m_timingFileName = optarg;
+                break;
+            case 'I':
+                parameters.m_inferenceFileName = optarg;
+                break;
+            case 'M':
+                parameters.m_memoryFileName = optarg;
+                break;
+            case 'A':
+                parameters.m_shouldReleaseEventMemory = true;
+                break;
+            case 'R':
+                parameters.m_releaseRssThresholdMB = atoi(optarg);
+                break;
+            case 'K':
+                parameters.m_nEventsPerRelease = atoi(optarg);
+                break;
+            case 'L':
+                parameters.m_mmapThresholdKB = atoi(optarg);
+                break;
+            case 'x':
+                parameters.m_shouldIndexEventFiles = true;
+                break;
             case 'p':
                 parameters.m_printOverallRecoStatus = true;
                 break;
@@ -164,6 +743,94 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
         }
     }
 
+    if (parameters.m_nThreads < 1)
+    {
+        std::cout << "LArReco, the number of threads must be at least one" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if (parameters.m_nEventsToPrefetch < 0)
+    {
+        std::cout << "LArReco, the number of events to prefetch cannot be negative" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if ((parameters.m_nTorchThreads < 0) || (parameters.m_nTorchInteropThreads < 0))
+    {
+        std::cout << "LArReco, the number of LibTorch threads cannot be negative" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+#ifndef LIBTORCH_DL
+    if ((parameters.m_nTorchThreads > 0) || (parameters.m_nTorchInteropThreads > 0) || !parameters.m_inferenceFileName.empty())
+    {
+        std::cout << "LArReco, LibTorch thread counts and inference timing require a build with LibTorch" << std::endl << std::endl;
+        return PrintOptions();
+    }
+#endif
+
+    // A daemon client needs no reconstruction configuration of its own
+    if (!parameters.m_daemonClientAddress.empty())
+        return true;
+
+    if (((parameters.m_nThreads > 1) || (parameters.m_nEventsToPrefetch > 0)) && parameters.m_eventFileNameList.empty() &&
+        parameters.m_eventListFileName.empty() && parameters.m_workerAddress.empty() &&
+        parameters.m_daemonAddress.empty())
+    {
+        std::cout << "LArReco, running with more than one thread, or with prefetching, requires an event file list" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if ((!parameters.m_coordinatorAddress.empty() + !parameters.m_workerAddress.empty() + !parameters.m_daemonAddress.empty()) > 1)
+    {
+        std::cout << "LArReco, a process can act as only one of coordinator, worker or daemon" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if ((!parameters.m_timingFileName.empty() || !parameters.m_inferenceFileName.empty() || !parameters.m_memoryFileName.empty() ||
+            parameters.m_shouldReleaseEventMemory) &&
+        (!parameters.m_daemonAddress.empty() ||
+            (parameters.m_eventFileNameList.empty() && parameters.m_eventListFileName.empty() && parameters.m_workerAddress.empty())))
+    {
+        std::cout << "LArReco, algorithm timing and memory options require an event file list, and are not available in daemon mode"
+                  << std::endl
+                  << std::endl;
+        return PrintOptions();
+    }
+
+    if (!parameters.m_eventListFileName.empty() &&
+        (!parameters.m_coordinatorAddress.empty() || !parameters.m_workerAddress.empty() || !parameters.m_daemonAddress.empty() ||
+            parameters.m_shouldIndexEventFiles))
+    {
+        std::cout << "LArReco, an event list cannot be combined with indexing, or coordinator, worker or daemon modes" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if (parameters.m_shouldIndexEventFiles &&
+        (parameters.m_eventFileNameList.empty() || !parameters.m_coordinatorAddress.empty() || !parameters.m_daemonAddress.empty()))
+    {
+        std::cout << "LArReco, indexing requires an event file list, and runs in place of coordinator or daemon" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if (!parameters.m_coordinatorAddress.empty() && parameters.m_eventFileNameList.empty())
+    {
+        std::cout << "LArReco, running as coordinator requires an event file list" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if ((parameters.m_nLocalWorkers < 0) || (parameters.m_nEventsPerWorkUnit < 1))
+    {
+        std::cout << "LArReco, invalid number of local workers or events per work unit" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
+    if ((parameters.m_releaseRssThresholdMB < 0) || (parameters.m_nEventsPerRelease < 0) || (parameters.m_mmapThresholdKB < 0))
+    {
+        std::cout << "LArReco, invalid memory release threshold, number of events per release or mmap threshold" << std::endl << std::endl;
+        return PrintOptions();
+    }
+
     return ProcessRecoOption(recoOption, parameters);
 }
 
@@ -177,9 +844,43 @@ bool PrintOptions()
               << std::endl
               << "    -i Settings            (required) [algorithm description: xml]" << std::endl
               << "    -e EventFileList       (optional) [colon-separated list of files: xml/pndr]" << std::endl
-              << "    -g GeometryFile        (optional) [detector geometry description: xml/pndr]" << std::endl
+              << "    -E EventList           (optional) [process only the listed events: <file or fileId> <event>, or Validation.C event file"
+              << std::endl
+              << "                                       with -e and -s as in the validated job]" << std::endl
+              << "    -g GeometryFile        (optional) [detector geometry description: xml/pndr, with xml cached as <file>.pndr]" << std::endl
               << "    -n NEventsToProcess    (optional) [no. of events to process]" << std::endl
-              << "    -s NEventsToSkip       (optional) [no. of events to skip in first file]" << std::endl
+              << "    -s NEventsToSkip       (optional) [no. of events to skip in first file, continuing into later files if indexed]" << std::endl
+              << "    -t NThreads            (optional) [no. of event-parallel threads, each with its own pandora instances; not if writing files]"
+              << std::endl
+              << "    -P NEventsToPrefetch   (optional) [no. of events read ahead, each into its own pandora instances; not if writing files]"
+              << std::endl
+              << "    -j NIntraOpThreads     (optional) [no. of LibTorch intra-op threads per inference call, in each event-parallel thread]"
+              << std::endl
+              << "    -J NInterOpThreads     (optional) [no. of LibTorch inter-op threads, shared by the process]" << std::endl
+              << "    -C CoordinatorAddress  (optional) [shard event file list across workers: unix:<path> or <host>:<port>]" << std::endl
+              << "    -W WorkerAddress       (optional) [process events issued by coordinator: unix:<path> or <host>:<port>]" << std::endl
+              << "    -w NLocalWorkers       (optional) [no. of worker processes started by coordinator]" << std::endl
+              << "    -u NEventsPerWorkUnit  (optional) [max no. of events in each work unit issued by coordinator]" << std::endl
+              << "    -m OutputFileList      (optional) [colon-separated list of worker output files merged by coordinator]" << std::endl
+              << "    -D DaemonAddress       (optional) [keep instances alive, serving event processing requests: unix:<path>]" << std::endl
+              << "                                       [output files, e.g. Validation.root, hold all requests and complete at shutdown]"
+              << std::endl
+              << "    -q DaemonAddress       (optional) [submit -e, -s and -n to a running daemon, or stop it if no -e given]" << std::endl
+              << "    -T TimingFile          (optional) [per-event algorithm timings: csv, or json if named .json; summary in <name>_Summary]"
+              << std::endl
+              << "    -I InferenceFile       (optional) [per-event time in LibTorch operators, i.e. network inference, without -T: csv]"
+              << std::endl
+              << "    -M MemoryFile          (optional) [per-event peak RSS, and allocations if built to count them: csv; percentiles in <name>_Summary]"
+              << std::endl
+              << "    -A                     (optional) [return memory freed by event resets to the system, limiting heap growth]" << std::endl
+              << "    -R ReleaseRssMB        (optional) [with -A, release after any event ending above this resident memory; default 0, none]"
+              << std::endl
+              << "    -K NEventsPerRelease   (optional) [with -A, release after this no. of events in any case; default 10, 0 for never]"
+              << std::endl
+              << "    -L MmapThresholdKB     (optional) [with -A, fixed allocator mmap threshold; default 1024, 0 for dynamic threshold]"
+              << std::endl
+              << "    -x                     (optional) [write event index <file>.index for each pndr file in event file list, then exit]"
+              << std::endl
               << "    -p                     (optional) [print status]" << std::endl
               << "    -N                     (optional) [print event numbers]" << std::endl
               << std::endl;
@@ -306,10 +1007,28 @@ void ProcessExternalParameters(const Parameters &parameters, const Pandora *cons
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetExternalParameters(*pPandora, "LArMaster", pEventSteeringParameters));
 
 #ifdef LIBTORCH_DL
+    // ATTN The LibTorch thread pools are process-wide, and the inter-op count cannot change once used, so are set with the first instance
+    static std::once_flag torchThreadsFlag;
+    std::call_once(torchThreadsFlag,
+        [&parameters]()
+        {
+            if (parameters.m_nTorchThreads > 0)
+                at::set_num_threads(parameters.m_nTorchThreads);
+
+            if (parameters.m_nTorchInteropThreads > 0)
+                at::set_num_interop_threads(parameters.m_nTorchInteropThreads);
+        });
+
     auto *const pEventSettingsParametersCopy = new lar_content::MasterAlgorithm::ExternalSteeringParameters(*pEventSteeringParameters);
     PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=,
         pandora::ExternallyConfiguredAlgorithm::SetExternalParameters(*pPandora, "LArDLMaster", pEventSettingsParametersCopy));
 #endif
+
+    if (!parameters.m_timingFileName.empty())
+    {
+        auto *const pTimedSteeringParameters = new lar_content::MasterAlgorithm::ExternalSteeringParameters(*pEventSteeringParameters);
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetExternalParameters(*pPandora, "LArRecoTimedMaster", pTimedSteeringParameters));
+    }
 }
 
 } // namespace lar_reco
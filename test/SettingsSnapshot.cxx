@@ -0,0 +1,274 @@
+/**
+ *  @file   LArReco/test/SettingsSnapshot.cxx
+ *
+ *  @brief  Implementation of the settings snapshot class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+#include "Xml/tinyxml.h"
+
+#include "larpandoracontent/LArHelpers/LArFileHelper.h"
+
+#include "PandoraInterface.h"
+#include "SettingsSnapshot.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace pandora;
+
+namespace
+{
+
+/**
+ *  @brief  Write a file via a temporary file, so that concurrent readers never see a partially written file
+ *
+ *  @param  path the path to the file
+ *  @param  contents the file contents
+ */
+void WriteFile(const std::string &path, const std::string &contents)
+{
+    const std::string temporaryPath(path + ".tmp" + std::to_string(::getpid()));
+
+    std::ofstream file(temporaryPath, std::ios::trunc);
+    file << contents;
+    file.close();
+
+    if (!file.good() || (0 != std::rename(temporaryPath.c_str(), path.c_str())))
+    {
+        std::remove(temporaryPath.c_str());
+        std::cout << "LArReco, unable to write " << path << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the name of a file, without its directory or extension
+ *
+ *  @param  path the path to the file
+ *
+ *  @return the file name stem
+ */
+std::string GetFileNameStem(const std::string &path)
+{
+    const std::string fileName(path.substr(path.find_last_of('/') + 1));
+    return fileName.substr(0, fileName.find_last_of('.'));
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+SettingsSnapshot::SettingsSnapshot(const std::string &settingsFile, const std::string &snapshotDirectory) :
+    m_settingsFile(settingsFile),
+    m_snapshotDirectory(GetAbsolutePath(snapshotDirectory)),
+    m_snapshotName(GetFileNameStem(settingsFile) + "_Timing")
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string SettingsSnapshot::GetSettingsFile() const
+{
+    const std::string snapshotSettingsFile(m_snapshotDirectory + "/" + m_snapshotName + ".xml");
+
+    // ATTN Without the instrumented snapshot the requested timing cannot be recorded, so there is no fallback to the original settings
+    if (!this->IsUpToDate())
+    {
+        this->Write();
+        std::cout << "LArReco, created settings snapshot " << snapshotSettingsFile << std::endl;
+    }
+
+    const std::string searchPath(SettingsSnapshot::GetSearchPath());
+    ::setenv("FW_SEARCH_PATH", (m_snapshotDirectory + (searchPath.empty() ? "" : ":" + searchPath)).c_str(), 1);
+
+    return snapshotSettingsFile;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SettingsSnapshot::IsUpToDate() const
+{
+    std::ifstream manifest(m_snapshotDirectory + "/" + m_snapshotName + ".manifest");
+    std::string settingsLine, searchPathLine, line;
+
+    if (!std::getline(manifest, settingsLine) || (settingsLine != "SETTINGS " + GetAbsolutePath(m_settingsFile)) ||
+        !std::getline(manifest, searchPathLine) || (searchPathLine != "FW_SEARCH_PATH " + SettingsSnapshot::GetSearchPath()))
+    {
+        return false;
+    }
+
+    SourceFile snapshotFile;
+
+    if (!SettingsSnapshot::GetFileStatus(m_snapshotDirectory + "/" + m_snapshotName + ".xml", snapshotFile))
+        return false;
+
+    while (std::getline(manifest, line))
+    {
+        SourceFile recordedFile, currentFile;
+        std::istringstream lineStream(line);
+        lineStream >> recordedFile.m_modificationTime >> recordedFile.m_size;
+        std::getline(lineStream >> std::ws, recordedFile.m_path);
+
+        if (!SettingsSnapshot::GetFileStatus(recordedFile.m_path, currentFile) ||
+            (currentFile.m_modificationTime != recordedFile.m_modificationTime) || (currentFile.m_size != recordedFile.m_size))
+        {
+            std::cout << "LArReco, settings snapshot is stale, as " << recordedFile.m_path << " has changed" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsSnapshot::Write() const
+{
+    if ((0 != ::mkdir(m_snapshotDirectory.c_str(), 0755)) && (EEXIST != errno))
+    {
+        std::cout << "LArReco, unable to create settings snapshot directory " << m_snapshotDirectory << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    const std::string settingsFile(GetAbsolutePath(m_settingsFile));
+    SourceFileList sourceFileList;
+    this->WriteSnapshotFile(settingsFile, m_snapshotDirectory + "/" + m_snapshotName + ".xml", "Master", sourceFileList);
+
+    // ATTN The manifest is written last, so that an interrupted write leaves the snapshot marked as stale
+    std::ostringstream manifest;
+    manifest << "SETTINGS " << settingsFile << std::endl << "FW_SEARCH_PATH " << SettingsSnapshot::GetSearchPath() << std::endl;
+
+    for (const SourceFile &sourceFile : sourceFileList)
+        manifest << sourceFile.m_modificationTime << " " << sourceFile.m_size << " " << sourceFile.m_path << std::endl;
+
+    WriteFile(m_snapshotDirectory + "/" + m_snapshotName + ".manifest", manifest.str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsSnapshot::WriteSnapshotFile(
+    const std::string &sourcePath, const std::string &snapshotPath, const std::string &instanceLabel, SourceFileList &sourceFileList) const
+{
+    SourceFile sourceFile;
+
+    if (!SettingsSnapshot::GetFileStatus(sourcePath, sourceFile))
+    {
+        std::cout << "LArReco, unable to find settings file " << sourcePath << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    sourceFileList.push_back(sourceFile);
+    TiXmlDocument xmlDocument(sourcePath);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "LArReco, unable to load settings file " << sourcePath << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    const TiXmlHandle xmlDocumentHandle(&xmlDocument);
+    const TiXmlHandle xmlHandle(TiXmlHandle(xmlDocumentHandle.FirstChildElement().Element()));
+    const std::map<std::string, std::string> settingsFileTagToLabel{{"CRSettingsFile", "CR"}, {"NuSettingsFile", "Nu"}, {"SlicingSettingsFile", "Slicing"}};
+
+    for (TiXmlElement *pXmlElement = xmlHandle.FirstChild("algorithm").Element(); nullptr != pXmlElement;
+         pXmlElement = pXmlElement->NextSiblingElement("algorithm"))
+    {
+        for (const auto &tagToLabel : settingsFileTagToLabel)
+        {
+            TiXmlElement *const pFileElement(pXmlElement->FirstChildElement(tagToLabel.first.c_str()));
+
+            if (!pFileElement || !pFileElement->GetText())
+                continue;
+
+            // Named settings files are located as the master algorithm would locate them, then replaced by their snapshots
+            const std::string namedPath(GetAbsolutePath(lar_content::LArFileHelper::FindFileInPath(pFileElement->GetText(), "FW_SEARCH_PATH")));
+            const std::string namedSnapshotName(m_snapshotName + "." + namedPath.substr(namedPath.find_last_of('/') + 1));
+
+            this->WriteSnapshotFile(namedPath, m_snapshotDirectory + "/" + namedSnapshotName, tagToLabel.second, sourceFileList);
+            pFileElement->FirstChild()->SetValue(namedSnapshotName);
+        }
+    }
+
+    this->InsertTimingMarkers(xmlHandle.ToElement(), instanceLabel);
+
+    TiXmlPrinter xmlPrinter;
+    xmlDocument.Accept(&xmlPrinter);
+    WriteFile(snapshotPath, xmlPrinter.Str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsSnapshot::InsertTimingMarkers(TiXmlElement *const pPandoraElement, const std::string &instanceLabel) const
+{
+    if (!pPandoraElement)
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    TiXmlElement instanceLabelElement("InstanceLabel");
+    instanceLabelElement.InsertEndChild(TiXmlText(instanceLabel.c_str()));
+
+    for (TiXmlElement *pXmlElement = pPandoraElement->FirstChildElement("algorithm"); nullptr != pXmlElement;
+         pXmlElement = pXmlElement->NextSiblingElement("algorithm"))
+    {
+        const char *const pAlgorithmType(pXmlElement->Attribute("type"));
+        const std::string algorithmType(pAlgorithmType ? pAlgorithmType : "");
+
+        if (("LArMaster" == algorithmType) || ("LArDLMaster" == algorithmType))
+            pXmlElement->SetAttribute("type", "LArRecoTimedMaster");
+
+        TiXmlElement nextAlgorithmElement("NextAlgorithm");
+        nextAlgorithmElement.InsertEndChild(TiXmlText(algorithmType.c_str()));
+
+        TiXmlElement markerElement("algorithm");
+        markerElement.SetAttribute("type", "LArRecoTimingMarker");
+        markerElement.InsertEndChild(instanceLabelElement);
+        markerElement.InsertEndChild(nextAlgorithmElement);
+        pPandoraElement->InsertBeforeChild(pXmlElement, markerElement);
+    }
+
+    TiXmlElement finalMarkerElement("algorithm");
+    finalMarkerElement.SetAttribute("type", "LArRecoTimingMarker");
+    finalMarkerElement.InsertEndChild(instanceLabelElement);
+    pPandoraElement->InsertEndChild(finalMarkerElement);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SettingsSnapshot::GetFileStatus(const std::string &path, SourceFile &sourceFile)
+{
+    struct stat fileStatus;
+
+    if (0 != ::stat(path.c_str(), &fileStatus))
+        return false;
+
+    sourceFile.m_path = path;
+    sourceFile.m_modificationTime = static_cast<long long>(fileStatus.st_mtime);
+    sourceFile.m_size = static_cast<long long>(fileStatus.st_size);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string SettingsSnapshot::GetSearchPath()
+{
+    const char *const pSearchPath(std::getenv("FW_SEARCH_PATH"));
+    return (pSearchPath ? std::string(pSearchPath) : std::string());
+}
+
+} // namespace lar_reco
@@ -0,0 +1,357 @@
+/**
+ *  @file   LArReco/test/SocketHelper.cxx
+ *
+ *  @brief  Implementation of the socket helper class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "SocketHelper.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace pandora;
+
+namespace
+{
+
+const std::string UNIX_ADDRESS_PREFIX("unix:");
+
+/**
+ *  @brief  Split a tcp address into host and port
+ *
+ *  @param  address the address
+ *  @param  host to receive the host
+ *  @param  port to receive the port
+ */
+void SplitTcpAddress(const std::string &address, std::string &host, std::string &port)
+{
+    const std::string::size_type separatorPosition(address.find_last_of(':'));
+
+    if ((std::string::npos == separatorPosition) || (address.size() == separatorPosition + 1))
+    {
+        std::cout << "LArReco, unable to interpret address " << address << ", expected unix:<path> or <host>:<port>" << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    host = address.substr(0, separatorPosition);
+    port = address.substr(separatorPosition + 1);
+}
+
+/**
+ *  @brief  Fill a unix domain socket address structure
+ *
+ *  @param  address the address
+ *  @param  socketAddress to receive the socket address
+ */
+void FillUnixAddress(const std::string &address, sockaddr_un &socketAddress)
+{
+    const std::string path(address.substr(UNIX_ADDRESS_PREFIX.size()));
+
+    if (path.empty() || (path.size() >= sizeof(socketAddress.sun_path)))
+    {
+        std::cout << "LArReco, invalid unix domain socket path " << path << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    std::memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sun_family = AF_UNIX;
+    std::strncpy(socketAddress.sun_path, path.c_str(), sizeof(socketAddress.sun_path) - 1);
+}
+
+/**
+ *  @brief  Whether an address refers to a unix domain socket
+ *
+ *  @param  address the address
+ *
+ *  @return boolean
+ */
+bool IsUnixAddress(const std::string &address)
+{
+    return (0 == address.compare(0, UNIX_ADDRESS_PREFIX.size(), UNIX_ADDRESS_PREFIX));
+}
+
+/**
+ *  @brief  Remove a unix domain socket file, refusing to remove a file of any other type
+ *
+ *  @param  path the path to the socket file
+ *
+ *  @return whether the path is now free, having held no file or a socket file
+ */
+bool RemoveSocketFile(const std::string &path)
+{
+    struct stat fileStatus;
+
+    if (0 != ::lstat(path.c_str(), &fileStatus))
+        return (ENOENT == errno);
+
+    if (!S_ISSOCK(fileStatus.st_mode))
+    {
+        std::cout << "LArReco, " << path << " exists and is not a socket, so will not be removed" << std::endl;
+        return false;
+    }
+
+    return ((0 == ::unlink(path.c_str())) || (ENOENT == errno));
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+int SocketHelper::Listen(const std::string &address)
+{
+    int listenSocket(-1);
+
+    if (IsUnixAddress(address))
+    {
+        sockaddr_un socketAddress;
+        FillUnixAddress(address, socketAddress);
+
+        // ATTN A socket file left by a previous listener must be removed before binding, but a path to any other file is a mistake
+        if (!RemoveSocketFile(socketAddress.sun_path))
+        {
+            std::cout << "LArReco, unable to bind to " << address << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        listenSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if ((listenSocket < 0) || (0 != ::bind(listenSocket, reinterpret_cast<sockaddr *>(&socketAddress), sizeof(socketAddress))))
+        {
+            std::cout << "LArReco, unable to bind to " << address << ": " << std::strerror(errno) << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+    }
+    else
+    {
+        std::string host, port;
+        SplitTcpAddress(address, host, port);
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+
+        addrinfo *pAddressInfo(nullptr);
+
+        if (0 != ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &pAddressInfo))
+        {
+            std::cout << "LArReco, unable to resolve " << address << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        listenSocket = ::socket(pAddressInfo->ai_family, pAddressInfo->ai_socktype, pAddressInfo->ai_protocol);
+        const int reuseAddress(1);
+
+        if ((listenSocket < 0) || (0 != ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress))) ||
+            (0 != ::bind(listenSocket, pAddressInfo->ai_addr, pAddressInfo->ai_addrlen)))
+        {
+            std::cout << "LArReco, unable to bind to " << address << ": " << std::strerror(errno) << std::endl;
+            ::freeaddrinfo(pAddressInfo);
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        ::freeaddrinfo(pAddressInfo);
+    }
+
+    if (0 != ::listen(listenSocket, SOMAXCONN))
+    {
+        std::cout << "LArReco, unable to listen on " << address << ": " << std::strerror(errno) << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    return listenSocket;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int SocketHelper::Accept(const int listenSocket, const int timeoutMilliseconds)
+{
+    pollfd pollDescriptor;
+    pollDescriptor.fd = listenSocket;
+    pollDescriptor.events = POLLIN;
+    pollDescriptor.revents = 0;
+
+    if ((::poll(&pollDescriptor, 1, timeoutMilliseconds) <= 0) || !(pollDescriptor.revents & POLLIN))
+        return -1;
+
+    return ::accept(listenSocket, nullptr, nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int SocketHelper::Connect(const std::string &address)
+{
+    int connectedSocket(-1);
+
+    if (IsUnixAddress(address))
+    {
+        sockaddr_un socketAddress;
+        FillUnixAddress(address, socketAddress);
+
+        connectedSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if ((connectedSocket >= 0) && (0 != ::connect(connectedSocket, reinterpret_cast<sockaddr *>(&socketAddress), sizeof(socketAddress))))
+        {
+            ::close(connectedSocket);
+            connectedSocket = -1;
+        }
+    }
+    else
+    {
+        std::string host, port;
+        SplitTcpAddress(address, host, port);
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *pAddressInfo(nullptr);
+
+        if (0 == ::getaddrinfo(host.c_str(), port.c_str(), &hints, &pAddressInfo))
+        {
+            for (const addrinfo *pCandidate = pAddressInfo; (nullptr != pCandidate) && (connectedSocket < 0); pCandidate = pCandidate->ai_next)
+            {
+                connectedSocket = ::socket(pCandidate->ai_family, pCandidate->ai_socktype, pCandidate->ai_protocol);
+
+                if ((connectedSocket >= 0) && (0 != ::connect(connectedSocket, pCandidate->ai_addr, pCandidate->ai_addrlen)))
+                {
+                    ::close(connectedSocket);
+                    connectedSocket = -1;
+                }
+            }
+
+            ::freeaddrinfo(pAddressInfo);
+        }
+    }
+
+    return connectedSocket;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SocketHelper::Close(const int socket, const std::string &address)
+{
+    ::close(socket);
+
+    if (!address.empty() && IsUnixAddress(address))
+        RemoveSocketFile(address.substr(UNIX_ADDRESS_PREFIX.size()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SocketHelper::ReadMessage(const int socket, std::string &message)
+{
+    message.clear();
+    char character(0);
+
+    while (true)
+    {
+        const ssize_t nBytes(::recv(socket, &character, 1, 0));
+
+        if ((nBytes < 0) && (EINTR == errno))
+            continue;
+
+        if (nBytes <= 0)
+            return false;
+
+        if ('\n' == character)
+            return true;
+
+        message.push_back(character);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SocketHelper::WriteMessage(const int socket, const std::string &message)
+{
+    return SocketHelper::WriteData(socket, message + "\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SocketHelper::ReadData(const int socket, const std::size_t nBytes, std::string &data)
+{
+    data.resize(nBytes);
+    std::size_t nBytesRead(0);
+
+    while (nBytesRead < nBytes)
+    {
+        const ssize_t nBytesReceived(::recv(socket, &data[nBytesRead], nBytes - nBytesRead, 0));
+
+        if ((nBytesReceived < 0) && (EINTR == errno))
+            continue;
+
+        if (nBytesReceived <= 0)
+            return false;
+
+        nBytesRead += nBytesReceived;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SocketHelper::WriteData(const int socket, const std::string &data)
+{
+#ifdef MSG_NOSIGNAL
+    const int flags(MSG_NOSIGNAL);
+#else
+    const int flags(0);
+#endif
+
+    std::size_t nBytesWritten(0);
+
+    while (nBytesWritten < data.size())
+    {
+        const ssize_t nBytesSent(::send(socket, data.data() + nBytesWritten, data.size() - nBytesWritten, flags));
+
+        if ((nBytesSent < 0) && (EINTR == errno))
+            continue;
+
+        if (nBytesSent <= 0)
+            return false;
+
+        nBytesWritten += nBytesSent;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string SocketHelper::GetAbsoluteAddress(const std::string &address)
+{
+    if (!IsUnixAddress(address))
+        return ((!address.empty() && (':' == address[0])) ? "localhost" + address : address);
+
+    if ('/' == address[UNIX_ADDRESS_PREFIX.size()])
+        return address;
+
+    char workingDirectory[4096];
+
+    if (!::getcwd(workingDirectory, sizeof(workingDirectory)))
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    return (UNIX_ADDRESS_PREFIX + workingDirectory + "/" + address.substr(UNIX_ADDRESS_PREFIX.size()));
+}
+
+} // namespace lar_reco
@@ -0,0 +1,597 @@
+/**
+ *  @file   LArReco/test/WorkDistribution.cxx
+ *
+ *  @brief  Implementation of the work coordinator and remote event queue
+ *
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+
+#include "SocketHelper.h"
+#include "WorkDistribution.h"
+
+#ifdef MONITORING
+#include "TFileMerger.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include <sys/wait.h>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+RemoteEventQueue::RemoteEventQueue(const std::string &coordinatorAddress) :
+    m_socket(-1),
+    m_fileName(""),
+    m_nextEventNumber(0),
+    m_nEventsInRange(0),
+    m_isAborted(false),
+    m_isDone(false)
+{
+    // ATTN Workers may be started before the coordinator is ready to accept connections
+    const unsigned int maxNConnectionAttempts(60);
+
+    for (unsigned int iAttempt = 0; (iAttempt < maxNConnectionAttempts) && (m_socket < 0); ++iAttempt)
+    {
+        if (iAttempt > 0)
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        m_socket = SocketHelper::Connect(coordinatorAddress);
+    }
+
+    if (m_socket < 0)
+    {
+        std::cout << "LArReco, unable to connect to coordinator at " << coordinatorAddress << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+RemoteEventQueue::~RemoteEventQueue()
+{
+    SocketHelper::Close(m_socket);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool RemoteEventQueue::GetNextEvent(EventId &eventId)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_isAborted && !m_isDone)
+    {
+        if (m_nEventsInRange > 0)
+        {
+            eventId = EventId(m_fileName, m_nextEventNumber++);
+            --m_nEventsInRange;
+            return true;
+        }
+
+        std::string reply;
+
+        if (!SocketHelper::WriteMessage(m_socket, "REQUEST") || !SocketHelper::ReadMessage(m_socket, reply))
+        {
+            std::cout << "LArReco, lost connection to coordinator" << std::endl;
+            m_isAborted = true;
+            break;
+        }
+
+        std::istringstream replyStream(reply);
+        std::string command;
+        replyStream >> command;
+
+        if ("WORK" == command)
+        {
+            replyStream >> m_nextEventNumber >> m_nEventsInRange;
+            std::getline(replyStream >> std::ws, m_fileName);
+            m_workUnitList.push_back(WorkUnit{m_fileName, m_nextEventNumber, m_nEventsInRange, m_nEventsInRange});
+        }
+        else if ("WAIT" == command)
+        {
+            // ATTN The lock is released while waiting, so that the other consumers can report the events they are processing
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            lock.lock();
+        }
+        else if ("DONE" == command)
+        {
+            m_isDone = true;
+        }
+        else
+        {
+            std::cout << "LArReco, unrecognised message from coordinator: " << reply << std::endl;
+            m_isAborted = true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RemoteEventQueue::SetEndOfFile(const EventId &eventId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Any events still to be issued from the current range also lie beyond the end of the file
+    const EventId firstRangeEventId(m_fileName, m_nextEventNumber);
+    unsigned int nRangeEvents(0);
+
+    if ((eventId.m_fileName == m_fileName) && (eventId.m_eventNumber < m_nextEventNumber))
+    {
+        nRangeEvents = m_nEventsInRange;
+        m_nEventsInRange = 0;
+    }
+
+    std::ostringstream message;
+    message << "ENDOFFILE " << eventId.m_eventNumber << " " << (1 + nRangeEvents) << " " << eventId.m_fileName;
+
+    if (!SocketHelper::WriteMessage(m_socket, message.str()))
+    {
+        std::cout << "LArReco, lost connection to coordinator" << std::endl;
+        m_isAborted = true;
+        return;
+    }
+
+    this->SetEventsResolved(eventId, 1);
+
+    if (nRangeEvents > 0)
+        this->SetEventsResolved(firstRangeEventId, nRangeEvents);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RemoteEventQueue::SetEventProcessed(const EventId &eventId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    this->SetEventsResolved(eventId, 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RemoteEventQueue::Abort()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isAborted = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RemoteEventQueue::SendOutputFiles()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // An aborted worker simply disconnects, so that the coordinator reissues its work units
+    if (m_isAborted)
+    {
+        std::cout << "LArReco, processing was aborted, output files will not be sent to coordinator" << std::endl;
+        return;
+    }
+
+    std::string reply;
+
+    if (!SocketHelper::WriteMessage(m_socket, "FINISHED") || !SocketHelper::ReadMessage(m_socket, reply) || (0 != reply.compare(0, 7, "OUTPUTS")))
+    {
+        std::cout << "LArReco, unable to report completion to coordinator" << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    StringVector outputFileNameVector;
+    XmlHelper::TokenizeString(reply.substr(7), outputFileNameVector, ": ");
+
+    for (const std::string &outputFileName : outputFileNameVector)
+    {
+        std::ifstream outputFile(outputFileName, std::ios::binary);
+
+        if (!outputFile.is_open())
+        {
+            std::cout << "LArReco, output file " << outputFileName << " not found" << std::endl;
+
+            if (!SocketHelper::WriteMessage(m_socket, "MISSING " + outputFileName))
+                throw StatusCodeException(STATUS_CODE_FAILURE);
+
+            continue;
+        }
+
+        const std::string contents((std::istreambuf_iterator<char>(outputFile)), std::istreambuf_iterator<char>());
+
+        if (!SocketHelper::WriteMessage(m_socket, "FILE " + std::to_string(contents.size()) + " " + outputFileName) ||
+            !SocketHelper::WriteData(m_socket, contents))
+        {
+            std::cout << "LArReco, unable to send output file " << outputFileName << " to coordinator" << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+    }
+
+    if (!SocketHelper::WriteMessage(m_socket, "END"))
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RemoteEventQueue::SetEventsResolved(const EventId &eventId, const unsigned int nEvents)
+{
+    for (WorkUnitList::iterator iter = m_workUnitList.begin(); iter != m_workUnitList.end(); ++iter)
+    {
+        if ((iter->m_fileName != eventId.m_fileName) || (eventId.m_eventNumber < iter->m_firstEventNumber) ||
+            (eventId.m_eventNumber - iter->m_firstEventNumber >= iter->m_nEvents) || (0 == iter->m_nUnresolvedEvents))
+        {
+            continue;
+        }
+
+        iter->m_nUnresolvedEvents -= std::min(nEvents, iter->m_nUnresolvedEvents);
+
+        if (iter->m_nUnresolvedEvents > 0)
+            return;
+
+        std::ostringstream message;
+        message << "COMPLETE " << iter->m_firstEventNumber << " " << iter->m_fileName;
+        m_workUnitList.erase(iter);
+
+        if (!m_isAborted && !SocketHelper::WriteMessage(m_socket, message.str()))
+        {
+            std::cout << "LArReco, lost connection to coordinator" << std::endl;
+            m_isAborted = true;
+        }
+
+        return;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+WorkCoordinator::WorkCoordinator(const std::string &address, const std::string &eventFileNameList, const unsigned int nEventsToSkip,
+    const int nEventsToProcess, const unsigned int nEventsPerWorkUnit, const std::string &outputFileNameList) :
+    m_address(address),
+    m_nEventsPerWorkUnit(nEventsPerWorkUnit),
+    m_listenSocket(-1),
+    m_eventQueue(eventFileNameList, nEventsToSkip, nEventsToProcess),
+    m_nConnections(0)
+{
+    XmlHelper::TokenizeString(outputFileNameList, m_outputFileNameVector, ":");
+    m_listenSocket = SocketHelper::Listen(m_address);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+WorkCoordinator::~WorkCoordinator()
+{
+    SocketHelper::Close(m_listenSocket, m_address);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool WorkCoordinator::Run(const unsigned int nLocalWorkers)
+{
+    std::cout << "LArReco, coordinator listening on " << m_address << std::endl;
+
+    std::vector<std::thread> threadVector;
+    unsigned int nRunningLocalWorkers(nLocalWorkers);
+    bool isComplete(false);
+
+    while (true)
+    {
+        while ((nRunningLocalWorkers > 0) && (::waitpid(-1, nullptr, WNOHANG) > 0))
+            --nRunningLocalWorkers;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            isComplete = this->IsComplete();
+
+            // Once the local workers have all exited, there is no one left to process any outstanding work
+            if (isComplete || ((nLocalWorkers > 0) && (0 == nRunningLocalWorkers) && m_issuedWorkUnitMap.empty()))
+                break;
+        }
+
+        const int socket(SocketHelper::Accept(m_listenSocket, 1000));
+
+        if (socket < 0)
+            continue;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const unsigned int connectionId(m_nConnections++);
+        m_issuedWorkUnitMap[connectionId];
+        threadVector.emplace_back(&WorkCoordinator::ServeWorker, this, connectionId, socket);
+    }
+
+    for (std::thread &thread : threadVector)
+        thread.join();
+
+    while ((nRunningLocalWorkers > 0) && (::waitpid(-1, nullptr, 0) > 0))
+        --nRunningLocalWorkers;
+
+    if (!isComplete)
+        std::cout << "LArReco, all local workers have exited before all work units were completed" << std::endl;
+
+    return isComplete;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void WorkCoordinator::MergeOutputFiles() const
+{
+    for (const std::string &outputFileName : m_outputFileNameVector)
+    {
+        OutputFileMap::const_iterator iter(m_gatheredFileMap.find(outputFileName));
+
+        if ((m_gatheredFileMap.end() == iter) || iter->second.empty())
+        {
+            std::cout << "LArReco, no worker copies of output file " << outputFileName << " were gathered" << std::endl;
+            continue;
+        }
+
+        StringVector gatheredFileNameVector(iter->second);
+        std::sort(gatheredFileNameVector.begin(), gatheredFileNameVector.end());
+
+#ifdef MONITORING
+        TFileMerger fileMerger(kFALSE);
+        fileMerger.SetPrintLevel(0);
+
+        bool isMerged(fileMerger.OutputFile(outputFileName.c_str(), "RECREATE"));
+
+        for (const std::string &gatheredFileName : gatheredFileNameVector)
+            isMerged = isMerged && fileMerger.AddFile(gatheredFileName.c_str(), kFALSE);
+
+        if (isMerged && fileMerger.Merge())
+        {
+            for (const std::string &gatheredFileName : gatheredFileNameVector)
+                std::remove(gatheredFileName.c_str());
+
+            std::cout << "LArReco, merged " << gatheredFileNameVector.size() << " worker copies into " << outputFileName << std::endl;
+            continue;
+        }
+
+        std::cout << "LArReco, unable to merge worker copies of " << outputFileName << ", these are retained" << std::endl;
+#else
+        std::cout << "LArReco, worker copies of " << outputFileName << " gathered, merge using:" << std::endl << "    hadd -f " << outputFileName;
+
+        for (const std::string &gatheredFileName : gatheredFileNameVector)
+            std::cout << " " << gatheredFileName;
+
+        std::cout << std::endl;
+#endif
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void WorkCoordinator::ServeWorker(const unsigned int connectionId, const int socket)
+{
+    bool isFinished(false);
+    OutputFileMap receivedFileMap;
+    std::string message;
+
+    while (!isFinished && SocketHelper::ReadMessage(socket, message))
+    {
+        std::istringstream messageStream(message);
+        std::string command;
+        messageStream >> command;
+
+        if ("REQUEST" == command)
+        {
+            if (!SocketHelper::WriteMessage(socket, this->GetWorkReply(connectionId)))
+                break;
+        }
+        else if ("ENDOFFILE" == command)
+        {
+            EventId eventId;
+            unsigned int nUnavailableEvents(0);
+            messageStream >> eventId.m_eventNumber >> nUnavailableEvents;
+            std::getline(messageStream >> std::ws, eventId.m_fileName);
+            this->SetEndOfFile(connectionId, eventId, nUnavailableEvents);
+        }
+        else if ("COMPLETE" == command)
+        {
+            EventId firstEventId;
+            messageStream >> firstEventId.m_eventNumber;
+            std::getline(messageStream >> std::ws, firstEventId.m_fileName);
+            this->SetWorkUnitProcessed(connectionId, firstEventId);
+        }
+        else if ("FINISHED" == command)
+        {
+            std::string outputFileNameList;
+
+            for (const std::string &outputFileName : m_outputFileNameVector)
+                outputFileNameList += (outputFileNameList.empty() ? "" : ":") + outputFileName;
+
+            if (!SocketHelper::WriteMessage(socket, "OUTPUTS " + outputFileNameList))
+                break;
+        }
+        else if ("FILE" == command)
+        {
+            std::size_t nBytes(0);
+            std::string outputFileName, gatheredFileName;
+            messageStream >> nBytes;
+            std::getline(messageStream >> std::ws, outputFileName);
+
+            if (!this->ReceiveOutputFile(connectionId, socket, nBytes, outputFileName, gatheredFileName))
+                break;
+
+            receivedFileMap[outputFileName].push_back(gatheredFileName);
+        }
+        else if ("MISSING" == command)
+        {
+            std::cout << "LArReco, worker " << connectionId << " did not produce output file " << message.substr(8) << std::endl;
+        }
+        else if ("END" == command)
+        {
+            isFinished = true;
+        }
+        else
+        {
+            std::cout << "LArReco, unrecognised message from worker " << connectionId << ": " << message << std::endl;
+            break;
+        }
+    }
+
+    SocketHelper::Close(socket);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (isFinished)
+    {
+        for (const OutputFileMap::value_type &mapEntry : receivedFileMap)
+        {
+            StringVector &gatheredFileNameVector(m_gatheredFileMap[mapEntry.first]);
+            gatheredFileNameVector.insert(gatheredFileNameVector.end(), mapEntry.second.begin(), mapEntry.second.end());
+        }
+    }
+    else
+    {
+        // The results of a worker that does not deliver its outputs are lost, so all of its work units must be reprocessed
+        unsigned int nReturnedWorkUnits(0);
+
+        for (const WorkUnit &workUnit : m_issuedWorkUnitMap.at(connectionId))
+        {
+            if (workUnit.m_nEvents > 0)
+            {
+                m_returnedWorkUnits.push_back(workUnit);
+                ++nReturnedWorkUnits;
+            }
+        }
+
+        for (const OutputFileMap::value_type &mapEntry : receivedFileMap)
+        {
+            for (const std::string &gatheredFileName : mapEntry.second)
+                std::remove(gatheredFileName.c_str());
+        }
+
+        std::cout << "LArReco, lost connection to worker " << connectionId << ", reissuing " << nReturnedWorkUnits << " work units" << std::endl;
+    }
+
+    m_issuedWorkUnitMap.erase(connectionId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string WorkCoordinator::GetWorkReply(const unsigned int connectionId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    WorkUnit workUnit;
+
+    if (!m_returnedWorkUnits.empty())
+    {
+        workUnit = m_returnedWorkUnits.front();
+        m_returnedWorkUnits.pop_front();
+    }
+    else
+    {
+        EventId firstEventId;
+
+        if (!m_eventQueue.GetNextEventRange(m_nEventsPerWorkUnit, firstEventId, workUnit.m_nEvents))
+        {
+            // Wait while any work unit, including those of the requesting worker, is still being processed, as it would be reissued were
+            // its worker to fail
+            for (const auto &mapEntry : m_issuedWorkUnitMap)
+            {
+                for (const WorkUnit &issuedWorkUnit : mapEntry.second)
+                {
+                    if (!issuedWorkUnit.m_isProcessed)
+                        return "WAIT";
+                }
+            }
+
+            return "DONE";
+        }
+
+        workUnit.m_fileName = firstEventId.m_fileName;
+        workUnit.m_firstEventNumber = firstEventId.m_eventNumber;
+    }
+
+    workUnit.m_isProcessed = false;
+    m_issuedWorkUnitMap.at(connectionId).push_back(workUnit);
+
+    return ("WORK " + std::to_string(workUnit.m_firstEventNumber) + " " + std::to_string(workUnit.m_nEvents) + " " + workUnit.m_fileName);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void WorkCoordinator::SetEndOfFile(const unsigned int connectionId, const EventId &eventId, const unsigned int nUnavailableEvents)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_eventQueue.SetEndOfFile(eventId, nUnavailableEvents);
+
+    for (WorkUnit &workUnit : m_issuedWorkUnitMap.at(connectionId))
+    {
+        if (workUnit.m_fileName != eventId.m_fileName)
+            continue;
+
+        if (workUnit.m_firstEventNumber >= eventId.m_eventNumber)
+        {
+            workUnit.m_nEvents = 0;
+        }
+        else
+        {
+            workUnit.m_nEvents = std::min(workUnit.m_nEvents, eventId.m_eventNumber - workUnit.m_firstEventNumber);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void WorkCoordinator::SetWorkUnitProcessed(const unsigned int connectionId, const EventId &firstEventId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (WorkUnit &workUnit : m_issuedWorkUnitMap.at(connectionId))
+    {
+        if ((workUnit.m_fileName == firstEventId.m_fileName) && (workUnit.m_firstEventNumber == firstEventId.m_eventNumber) && !workUnit.m_isProcessed)
+        {
+            workUnit.m_isProcessed = true;
+            return;
+        }
+    }
+
+    std::cout << "LArReco, worker " << connectionId << " reported an unknown work unit, event " << firstEventId.m_eventNumber << " of "
+              << firstEventId.m_fileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool WorkCoordinator::ReceiveOutputFile(const unsigned int connectionId, const int socket, const std::size_t nBytes,
+    const std::string &outputFileName, std::string &gatheredFileName) const
+{
+    std::string contents;
+
+    if (!SocketHelper::ReadData(socket, nBytes, contents))
+        return false;
+
+    const std::string::size_type separatorPosition(outputFileName.find_last_of('/'));
+    const std::string baseName((std::string::npos != separatorPosition) ? outputFileName.substr(separatorPosition + 1) : outputFileName);
+    gatheredFileName = "LArRecoWorker" + std::to_string(connectionId) + "_" + baseName;
+
+    std::ofstream gatheredFile(gatheredFileName, std::ios::binary | std::ios::trunc);
+    gatheredFile.write(contents.data(), contents.size());
+
+    if (!gatheredFile.good())
+    {
+        std::cout << "LArReco, unable to write " << gatheredFileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool WorkCoordinator::IsComplete()
+{
+    return ((m_nConnections > 0) && m_issuedWorkUnitMap.empty() && m_returnedWorkUnits.empty() && m_eventQueue.IsExhausted());
+}
+
+} // namespace lar_reco
@@ -8,10 +8,14 @@
 #ifndef NEW_LAR_VALIDATION_H
 #define NEW_LAR_VALIDATION_H 1
 
+#include <exception>
+#include <functional>
+#include <iostream>
 #include <limits>
 
 typedef std::vector<int> IntVector;
 typedef std::vector<float> FloatVector;
+typedef std::vector<std::string> StringVector;
 
 /**
  * @brief   Parameters class
@@ -27,6 +31,8 @@ public:
     bool                    m_displayMatchedEvents;     ///< Whether to display matching results for individual events
     int                     m_skipEvents;               ///< The number of events to skip
     int                     m_nEventsToProcess;         ///< The number of events to process
+    int                     m_nThreads;                 ///< The number of threads, each processing its own event-aligned range of chain entries
+    std::string             m_eventIndexFileName;       ///< File in which to keep the event index, reused while the chain has the same, unmodified files
     bool                    m_applyUbooneFiducialCut;   ///< Whether to apply uboone fiducial volume cut to true neutrino vertex position
     bool                    m_applySBNDFiducialCut;     ///< Whether to apply sbnd fiducial volume cut to true neutrino vertex position
     bool                    m_correctTrackShowerId;     ///< Whether to demand that pfos are correctly flagged as tracks or showers
@@ -87,51 +93,57 @@ SimpleThreeVector operator+(const SimpleThreeVector &lhs, const SimpleThreeVecto
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
- *  @brief SimpleMCPrimary class
+ *  @brief SimpleMCPrimaryColumns class, the mc primaries of an event stored column by column, with the primaries of each target contiguous
  */
-class SimpleMCPrimary
+class SimpleMCPrimaryColumns
 {
 public:
     /**
-     *  @brief  Constructor
+     *  @brief  Get the number of mc primaries
+     *
+     *  @return the number of mc primaries
      */
-    SimpleMCPrimary();
-
-    int                 m_primaryId;                    ///< The identifier
-    int                 m_pdgCode;                      ///< The pdg code
-    float               m_energy;                       ///< The energy
-    SimpleThreeVector   m_momentum;                     ///< The momentum
-    SimpleThreeVector   m_vertex;                       ///< The vertex
-    SimpleThreeVector   m_endpoint;                     ///< The endpoint
-    int                 m_nMCHitsTotal;                 ///< The total number of mc hits
-    int                 m_nMCHitsU;                     ///< The number of u mc hits
-    int                 m_nMCHitsV;                     ///< The number of v mc hits
-    int                 m_nMCHitsW;                     ///< The number of w mc hits
-
-    int                 m_nPrimaryMatchedPfos;          ///< The number of matched pfos
-    int                 m_nPrimaryMatchedNuPfos;        ///< The number of matched nu pfos
-    int                 m_nPrimaryMatchedCRPfos;        ///< The number of matched cr pfos
-    int                 m_bestMatchPfoId;               ///< The best match pfo identifier
-    int                 m_bestMatchPfoPdgCode;          ///< The best match pfo pdg code
-    int                 m_bestMatchPfoIsRecoNu;         ///< Whether best match pfo is reconstructed as part of a neutrino hierarchy
-    int                 m_bestMatchPfoRecoNuId;         ///< The identifier of the associated reco neutrino (if part of a neutrino hierarchy)
-    int                 m_bestMatchPfoIsTestBeam;       ///< Whether best match pfo is reconstructed as a test beam particle
-    int                 m_bestMatchPfoNHitsTotal;       ///< The best match pfo total number of pfo hits
-    int                 m_bestMatchPfoNHitsU;           ///< The best match pfo number of u pfo hits
-    int                 m_bestMatchPfoNHitsV;           ///< The best match pfo number of v pfo hits
-    int                 m_bestMatchPfoNHitsW;           ///< The best match pfo number of w pfo hits
-    int                 m_bestMatchPfoNSharedHitsTotal; ///< The best match pfo total number of matched hits
-    int                 m_bestMatchPfoNSharedHitsU;     ///< The best match pfo number of u matched hits
-    int                 m_bestMatchPfoNSharedHitsV;     ///< The best match pfo number of v matched hits
-    int                 m_bestMatchPfoNSharedHitsW;     ///< The best match pfo number of w matched hits
+    int GetNPrimaries() const;
+
+    IntVector           m_primaryIdList;                    ///< The identifiers
+    IntVector           m_pdgCodeList;                      ///< The pdg codes
+    FloatVector         m_energyList;                       ///< The energies
+    FloatVector         m_momentumXList;                    ///< The momentum x components
+    FloatVector         m_momentumYList;                    ///< The momentum y components
+    FloatVector         m_momentumZList;                    ///< The momentum z components
+    FloatVector         m_vertexXList;                      ///< The vertex x coordinates
+    FloatVector         m_vertexYList;                      ///< The vertex y coordinates
+    FloatVector         m_vertexZList;                      ///< The vertex z coordinates
+    FloatVector         m_endpointXList;                    ///< The endpoint x coordinates
+    FloatVector         m_endpointYList;                    ///< The endpoint y coordinates
+    FloatVector         m_endpointZList;                    ///< The endpoint z coordinates
+    IntVector           m_nMCHitsTotalList;                 ///< The total numbers of mc hits
+    IntVector           m_nMCHitsUList;                     ///< The numbers of u mc hits
+    IntVector           m_nMCHitsVList;                     ///< The numbers of v mc hits
+    IntVector           m_nMCHitsWList;                     ///< The numbers of w mc hits
+
+    IntVector           m_nPrimaryMatchedPfosList;          ///< The numbers of matched pfos
+    IntVector           m_nPrimaryMatchedNuPfosList;        ///< The numbers of matched nu pfos
+    IntVector           m_nPrimaryMatchedCRPfosList;        ///< The numbers of matched cr pfos
+    IntVector           m_bestMatchPfoIdList;               ///< The best match pfo identifiers
+    IntVector           m_bestMatchPfoPdgCodeList;          ///< The best match pfo pdg codes
+    IntVector           m_bestMatchPfoIsRecoNuList;         ///< Whether each best match pfo is reconstructed as part of a neutrino hierarchy
+    IntVector           m_bestMatchPfoRecoNuIdList;         ///< The identifiers of the associated reco neutrinos (if part of a neutrino hierarchy)
+    IntVector           m_bestMatchPfoIsTestBeamList;       ///< Whether each best match pfo is reconstructed as a test beam particle
+    IntVector           m_bestMatchPfoNHitsTotalList;       ///< The best match pfo total numbers of pfo hits
+    IntVector           m_bestMatchPfoNHitsUList;           ///< The best match pfo numbers of u pfo hits
+    IntVector           m_bestMatchPfoNHitsVList;           ///< The best match pfo numbers of v pfo hits
+    IntVector           m_bestMatchPfoNHitsWList;           ///< The best match pfo numbers of w pfo hits
+    IntVector           m_bestMatchPfoNSharedHitsTotalList; ///< The best match pfo total numbers of matched hits
+    IntVector           m_bestMatchPfoNSharedHitsUList;     ///< The best match pfo numbers of u matched hits
+    IntVector           m_bestMatchPfoNSharedHitsVList;     ///< The best match pfo numbers of v matched hits
+    IntVector           m_bestMatchPfoNSharedHitsWList;     ///< The best match pfo numbers of w matched hits
 };
 
-typedef std::vector<SimpleMCPrimary> SimpleMCPrimaryList;
-
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
- *  @brief SimpleMCTarget class
+ *  @brief SimpleMCTarget class, the details of a single target, as read from one entry of the validation tree
  */
 class SimpleMCTarget
 {
@@ -167,10 +179,84 @@ public:
     int                 m_nTargetNuLosses;              ///< The number of neutrino primaries with no matches
 
     int                 m_nTargetPrimaries;             ///< The number of target mc primaries
-    SimpleMCPrimaryList m_mcPrimaryList;                ///< The list of mc primaries
 };
 
-typedef std::vector<SimpleMCTarget> SimpleMCTargetList;
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief SimpleMCTargetColumns class, the mc targets of an event stored column by column
+ */
+class SimpleMCTargetColumns
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    SimpleMCTargetColumns();
+
+    /**
+     *  @brief  Add a target, the mc primaries of which follow those of the previous target
+     *
+     *  @param  simpleMCTarget the target details
+     */
+    void Add(const SimpleMCTarget &simpleMCTarget);
+
+    /**
+     *  @brief  Get the number of mc targets
+     *
+     *  @return the number of mc targets
+     */
+    int GetNTargets() const;
+
+    /**
+     *  @brief  Get the position of the first mc primary of a target
+     *
+     *  @param  iTarget the position of the target
+     *
+     *  @return the position of the first mc primary
+     */
+    int GetFirstPrimary(const int iTarget) const;
+
+    /**
+     *  @brief  Get the position after that of the last mc primary of a target
+     *
+     *  @param  iTarget the position of the target
+     *
+     *  @return the position after that of the last mc primary
+     */
+    int GetEndPrimary(const int iTarget) const;
+
+    IntVector           m_interactionTypeList;          ///< The target interaction types
+    IntVector           m_mcNuanceCodeList;             ///< The target nuance codes
+    IntVector           m_isNeutrinoList;               ///< Whether each target is a neutrino
+    IntVector           m_isBeamParticleList;           ///< Whether each target is a beam particle
+    IntVector           m_isCosmicRayList;              ///< Whether each target is a cosmic ray
+
+    FloatVector         m_targetVertexXList;            ///< The target vertex x coordinates
+    FloatVector         m_targetVertexYList;            ///< The target vertex y coordinates
+    FloatVector         m_targetVertexZList;            ///< The target vertex z coordinates
+    FloatVector         m_recoVertexXList;              ///< The reco vertex x coordinates, if available
+    FloatVector         m_recoVertexYList;              ///< The reco vertex y coordinates, if available
+    FloatVector         m_recoVertexZList;              ///< The reco vertex z coordinates, if available
+
+    IntVector           m_isCorrectNuList;              ///< Whether each target was correctly reconstructed as a neutrino
+    IntVector           m_isCorrectTBList;              ///< Whether each target was correctly reconstructed as a beam particle
+    IntVector           m_isCorrectCRList;              ///< Whether each target was correctly reconstructed as a cosmic ray
+    IntVector           m_isFakeNuList;                 ///< Whether each target was reconstructed as a fake neutrino
+    IntVector           m_isFakeCRList;                 ///< Whether each target was reconstructed as a fake cosmic ray
+    IntVector           m_isSplitNuList;                ///< Whether each target was reconstructed as a split neutrino
+    IntVector           m_isSplitCRList;                ///< Whether each target was reconstructed as a split cosmic ray
+    IntVector           m_isLostList;                   ///< Whether each target was lost (not reconstructed)
+
+    IntVector           m_nTargetMatchesList;           ///< The numbers of pfo matches to each target
+    IntVector           m_nTargetNuMatchesList;         ///< The numbers of neutrino pfo matches to each target
+    IntVector           m_nTargetCRMatchesList;         ///< The numbers of cosmic ray pfo matches to each target
+    IntVector           m_nTargetGoodNuMatchesList;     ///< The numbers of good neutrino pfo matches to each target
+    IntVector           m_nTargetNuSplitsList;          ///< The numbers of split neutrino pfo matches to each target
+    IntVector           m_nTargetNuLossesList;          ///< The numbers of neutrino primaries with no matches
+
+    IntVector           m_firstPrimaryList;             ///< The position of the first mc primary of each target, followed by the number of mc primaries
+};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -185,11 +271,11 @@ public:
      */
     SimpleMCEvent();
 
-    int                 m_fileIdentifier;               ///< The file identifier
-    int                 m_eventNumber;                  ///< The event number
+    int                     m_fileIdentifier;           ///< The file identifier
+    int                     m_eventNumber;              ///< The event number
 
-    int                 m_nMCTargets;                   ///< The number of mc targets
-    SimpleMCTargetList  m_mcTargetList;                 ///< The list of mc targets
+    SimpleMCTargetColumns   m_mcTargets;                ///< The mc targets
+    SimpleMCPrimaryColumns  m_mcPrimaries;              ///< The mc primaries, target by target
 };
 
 typedef std::vector<SimpleMCEvent> SimpleMCEventList;
@@ -216,6 +302,10 @@ enum ExpectedPrimary : int
     OTHER_PRIMARY
 };
 
+typedef std::vector<ExpectedPrimary> ExpectedPrimaryList;
+
+static const int N_EXPECTED_PRIMARIES = OTHER_PRIMARY + 1;      ///< The number of expected primaries, indexing the per-primary accumulators
+
 /**
  *  @brief  Get a string representation of an interaction type
  *
@@ -399,6 +489,8 @@ enum InteractionType : int
     ALL_INTERACTIONS
 };
 
+static const int N_INTERACTION_TYPES = ALL_INTERACTIONS + 1;    ///< The number of interaction types, indexing the per-interaction accumulators
+
 /**
  *  @brief  Get a string representation of an interaction type
  *
@@ -429,8 +521,54 @@ public:
     unsigned int            m_correctId;                ///< The number of times the mc primary particle id was correct
 };
 
-typedef std::map<ExpectedPrimary, CountingDetails> CountingMap;
-typedef std::map<InteractionType, CountingMap> InteractionCountingMap;
+typedef std::vector<CountingDetails> CountingDetailsList;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief   InteractionCountingTable class, the counting details for each interaction type and expected primary, indexed by enum value.
+ *          An interaction type and expected primary is present once it has been counted.
+ */
+class InteractionCountingTable
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    InteractionCountingTable();
+
+    /**
+     *  @brief  Get the counting details for an interaction type and expected primary
+     *
+     *  @param  interactionType the interaction type
+     *  @param  expectedPrimary the expected primary
+     *
+     *  @return the counting details
+     */
+    CountingDetails &GetCountingDetails(const InteractionType interactionType, const ExpectedPrimary expectedPrimary);
+
+    /**
+     *  @brief  Get the counting details for an interaction type and expected primary
+     *
+     *  @param  interactionType the interaction type
+     *  @param  expectedPrimary the expected primary
+     *
+     *  @return the counting details
+     */
+    const CountingDetails &GetCountingDetails(const InteractionType interactionType, const ExpectedPrimary expectedPrimary) const;
+
+    /**
+     *  @brief  Whether any expected primary has been counted for an interaction type
+     *
+     *  @param  interactionType the interaction type
+     *
+     *  @return boolean
+     */
+    bool IsPresent(const InteractionType interactionType) const;
+
+private:
+    CountingDetailsList     m_countingDetailsList;      ///< The counting details, expected primary by expected primary for each interaction type
+};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -455,31 +593,126 @@ public:
     float                   m_trueMomentum;             ///< The true momentum of the mc primary
 };
 
-typedef std::map<ExpectedPrimary, PrimaryResult> PrimaryResultMap;
-
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
- * @brief   TargetResult class
+ * @brief   TargetResultColumns class, the results for a list of targets stored column by column. Each target has a primary result for each
+ *          of its distinct expected primaries, in expected primary order, with the primary results of each target contiguous.
  */
-class TargetResult
+class TargetResultColumns
 {
 public:
     /**
      *  @brief  Default constructor
      */
-    TargetResult();
+    TargetResultColumns();
 
-    int                     m_fileIdentifier;           ///< The file identifier
-    int                     m_eventNumber;              ///< The event number
-    bool                    m_isCorrect;                ///< Whether the target is reconstructed correctly
-    bool                    m_hasRecoVertex;            ///< Whether a reco vertex is matched to the target
-    SimpleThreeVector       m_vertexOffset;             ///< The offset between the reco and true target vertices
-    PrimaryResultMap        m_primaryResultMap;         ///< The primary result map
+    /**
+     *  @brief  Add a primary result to the current target, which is completed by AddTarget
+     *
+     *  @param  expectedPrimary the expected primary
+     *  @param  primaryResult the primary result
+     */
+    void AddPrimary(const ExpectedPrimary expectedPrimary, const PrimaryResult &primaryResult);
+
+    /**
+     *  @brief  Add a target, with the primary results added since the previous target
+     *
+     *  @param  fileIdentifier the file identifier
+     *  @param  eventNumber the event number
+     *  @param  isCorrect whether the target is reconstructed correctly
+     *  @param  hasRecoVertex whether a reco vertex is matched to the target
+     *  @param  vertexOffset the offset between the reco and true target vertices
+     */
+    void AddTarget(const int fileIdentifier, const int eventNumber, const bool isCorrect, const bool hasRecoVertex, const SimpleThreeVector &vertexOffset);
+
+    /**
+     *  @brief  Append the targets, and their primary results, of another target result columns
+     *
+     *  @param  targetResultColumns the target result columns to append
+     */
+    void Append(const TargetResultColumns &targetResultColumns);
+
+    /**
+     *  @brief  Get the number of targets
+     *
+     *  @return the number of targets
+     */
+    int GetNTargets() const;
+
+    /**
+     *  @brief  Get the position of the first primary result of a target
+     *
+     *  @param  iTarget the position of the target
+     *
+     *  @return the position of the first primary result
+     */
+    int GetFirstPrimary(const int iTarget) const;
+
+    /**
+     *  @brief  Get the position after that of the last primary result of a target
+     *
+     *  @param  iTarget the position of the target
+     *
+     *  @return the position after that of the last primary result
+     */
+    int GetEndPrimary(const int iTarget) const;
+
+    IntVector               m_fileIdentifierList;       ///< The file identifiers
+    IntVector               m_eventNumberList;          ///< The event numbers
+    IntVector               m_isCorrectList;            ///< Whether each target is reconstructed correctly
+    IntVector               m_hasRecoVertexList;        ///< Whether a reco vertex is matched to each target
+    FloatVector             m_vertexOffsetXList;        ///< The x offsets between the reco and true target vertices
+    FloatVector             m_vertexOffsetYList;        ///< The y offsets between the reco and true target vertices
+    FloatVector             m_vertexOffsetZList;        ///< The z offsets between the reco and true target vertices
+    IntVector               m_firstPrimaryList;         ///< The position of the first primary result of each target, followed by the number of primary results
+
+    ExpectedPrimaryList     m_expectedPrimaryList;      ///< The expected primary of each primary result
+    IntVector               m_nPfoMatchesList;          ///< The total numbers of pfo matches for each primary
+    IntVector               m_nMCHitsTotalList;         ///< The numbers of hits in each mc primary
+    FloatVector             m_bestMatchCompletenessList;///< The completeness of each best matched pfo
+    FloatVector             m_bestMatchPurityList;      ///< The purity of each best matched pfo
+    IntVector               m_isCorrectParticleIdList;  ///< Whether each best matched pfo has the correct particle id
+    FloatVector             m_trueMomentumList;         ///< The true momentum of each mc primary
 };
 
-typedef std::vector<TargetResult> TargetResultList; // ATTN Not terribly efficient, but that's not the main aim here
-typedef std::map<InteractionType, TargetResultList> InteractionTargetResultMap;
+typedef std::vector<TargetResultColumns> TargetResultColumnsList;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief   InteractionTargetResultTable class, the target results for each interaction type, indexed by enum value. An interaction type is
+ *          present once a target result has been added for it.
+ */
+class InteractionTargetResultTable
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    InteractionTargetResultTable();
+
+    /**
+     *  @brief  Get the target results for an interaction type
+     *
+     *  @param  interactionType the interaction type
+     *
+     *  @return the target results
+     */
+    TargetResultColumns &GetTargetResults(const InteractionType interactionType);
+
+    /**
+     *  @brief  Get the target results for an interaction type
+     *
+     *  @param  interactionType the interaction type
+     *
+     *  @return the target results
+     */
+    const TargetResultColumns &GetTargetResults(const InteractionType interactionType) const;
+
+private:
+    TargetResultColumnsList m_targetResultsList;        ///< The target results for each interaction type
+};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -502,7 +735,7 @@ public:
     TH1F                   *m_hVtxDeltaR;               ///< The vtx delta r histogram
 };
 
-typedef std::map<InteractionType, TargetHistogramCollection> InteractionTargetHistogramMap;
+typedef std::vector<TargetHistogramCollection> TargetHistogramCollectionList;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -525,8 +758,290 @@ public:
     TH1F                   *m_hPurity;                  ///< The primary (best match) purity histogram
 };
 
-typedef std::map<ExpectedPrimary, PrimaryHistogramCollection> PrimaryHistogramMap;
-typedef std::map<InteractionType, PrimaryHistogramMap> InteractionPrimaryHistogramMap;
+typedef std::vector<PrimaryHistogramCollection> PrimaryHistogramCollectionList;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  HistogramRegistry class, holding the target histogram collection for each interaction type and the primary histogram collection
+ *          for each interaction type and expected primary, indexed by enum value. Each collection is booked on first use, which is the only
+ *          time its histogram names are built, so that only the collections that are filled are created.
+ */
+class HistogramRegistry
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  histPrefix the histogram name prefix
+     */
+    HistogramRegistry(const std::string &histPrefix);
+
+    /**
+     *  @brief  Get the target histogram collection for an interaction type, booking it if required
+     *
+     *  @param  interactionType the interaction type
+     *
+     *  @return the target histogram collection
+     */
+    TargetHistogramCollection &GetTargetHistogramCollection(const InteractionType interactionType);
+
+    /**
+     *  @brief  Get the primary histogram collection for an interaction type and expected primary, booking it if required
+     *
+     *  @param  interactionType the interaction type
+     *  @param  expectedPrimary the expected primary
+     *
+     *  @return the primary histogram collection
+     */
+    PrimaryHistogramCollection &GetPrimaryHistogramCollection(const InteractionType interactionType, const ExpectedPrimary expectedPrimary);
+
+    /**
+     *  @brief  Get the primary histogram collections, expected primary by expected primary for each interaction type, booked or not
+     *
+     *  @return the primary histogram collections
+     */
+    const PrimaryHistogramCollectionList &GetPrimaryHistogramCollectionList() const;
+
+private:
+    /**
+     *  @brief  Book the histograms of a target histogram collection
+     *
+     *  @param  histPrefix the histogram prefix, identifying the interaction type
+     *  @param  targetHistogramCollection the target histogram collection
+     */
+    void BookTargetHistogramCollection(const std::string &histPrefix, TargetHistogramCollection &targetHistogramCollection) const;
+
+    /**
+     *  @brief  Book the histograms of a primary histogram collection
+     *
+     *  @param  histPrefix the histogram prefix, identifying the interaction type and expected primary
+     *  @param  primaryHistogramCollection the primary histogram collection
+     */
+    void BookPrimaryHistogramCollection(const std::string &histPrefix, PrimaryHistogramCollection &primaryHistogramCollection) const;
+
+    static const int                N_HIT_BINS = 35;                    ///< The number of bins in the number of hits histograms
+    static const int                N_MOMENTUM_BINS = 26;               ///< The number of bins in the momentum histograms
+
+    const std::string               m_histPrefix;                       ///< The histogram name prefix
+    float                           m_hitsBinning[N_HIT_BINS + 1];      ///< The bin edges of the number of hits histograms
+    TargetHistogramCollectionList   m_targetHistogramCollectionList;    ///< The target histogram collection for each interaction type
+    PrimaryHistogramCollectionList  m_primaryHistogramCollectionList;   ///< The primary histogram collections, expected primary by expected primary for each interaction type
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventIndex class, recording the range of chain entries, one per target, of each event in the validation tree. The files of the
+ *          chain, with their numbers of entries, sizes and modification times, are recorded with the index, so that an index file is only
+ *          reused for the same, unmodified files.
+ */
+class EventIndex
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    EventIndex();
+
+    /**
+     *  @brief  Fill the index from a chain, in a single pass reading only the event numbers
+     *
+     *  @param  pTChain the address of the chain
+     */
+    void Fill(TChain *const pTChain);
+
+    /**
+     *  @brief  Read the index from a file, checking that it was written for the same files as the chain, with the same numbers of entries,
+     *          sizes and modification times, and that the recorded event number is found at the first entry of a sample of events
+     *
+     *  @param  fileName the index file name
+     *  @param  pTChain the address of the chain
+     *
+     *  @return whether the file was read and matches the chain
+     */
+    bool Read(const std::string &fileName, TChain *const pTChain);
+
+    /**
+     *  @brief  Write the index to a file
+     *
+     *  @param  fileName the index file name
+     */
+    void Write(const std::string &fileName) const;
+
+    /**
+     *  @brief  Get the number of events
+     *
+     *  @return the number of events
+     */
+    int GetNEvents() const;
+
+    /**
+     *  @brief  Get the first chain entry of an event
+     *
+     *  @param  iEvent the position of the event in the chain
+     *
+     *  @return the first chain entry
+     */
+    int GetFirstEntry(const int iEvent) const;
+
+    /**
+     *  @brief  Get the chain entry after the last entry of an event
+     *
+     *  @param  iEvent the position of the event in the chain
+     *
+     *  @return the chain entry after the last entry
+     */
+    int GetEndEntry(const int iEvent) const;
+
+    /**
+     *  @brief  Get the event number of an event
+     *
+     *  @param  iEvent the position of the event in the chain
+     *
+     *  @return the event number
+     */
+    int GetEventNumber(const int iEvent) const;
+
+private:
+    /**
+     *  @brief  ChainFile class, identifying a file of the chain
+     */
+    class ChainFile
+    {
+    public:
+        std::string         m_fileName;                 ///< The file name
+        int                 m_nEntries;                 ///< The number of chain entries in the file
+        Long64_t            m_size;                     ///< The size of the file, in bytes, or -1 if unavailable
+        Long64_t            m_modificationTime;         ///< The modification time of the file, or -1 if unavailable
+    };
+
+    typedef std::vector<ChainFile> ChainFileList;
+
+    /**
+     *  @brief  Get the files of a chain, with the number of chain entries, size and modification time of each
+     *
+     *  @param  pTChain the address of the chain, for which the number of entries has already been calculated
+     *  @param  chainFileList to receive the chain files
+     */
+    static void GetChainFiles(TChain *const pTChain, ChainFileList &chainFileList);
+
+    /**
+     *  @brief  Whether the chain has the expected event number at the first entry of each of a sample of events, evenly spaced and
+     *          including the first and last events, so that checking does not read the whole chain
+     *
+     *  @param  pTChain the address of the chain
+     *  @param  firstEntryList the first chain entry of each event
+     *  @param  eventNumberList the expected event number of each event
+     *
+     *  @return boolean
+     */
+    static bool HasEventNumbers(TChain *const pTChain, const IntVector &firstEntryList, const IntVector &eventNumberList);
+
+    static const unsigned int N_CHECKED_EVENTS = 10;    ///< The number of events at which the event number is checked, on reading an index
+
+    IntVector               m_firstEntryList;           ///< The first chain entry of each event, followed by the number of chain entries
+    IntVector               m_eventNumberList;          ///< The event number of each event
+    ChainFileList           m_chainFileList;            ///< The files of the chain
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  ValidationReader class, reading events from the validation tree. Each branch is bound once, only the branches needed for the
+ *          requested output are enabled, and these are read through the tree cache, in large blocks, rather than basket by basket.
+ */
+class ValidationReader
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  pTChain the address of the chain
+     *  @param  parameters the parameters
+     */
+    ValidationReader(TChain *const pTChain, const Parameters &parameters);
+
+    /**
+     *  @brief  Destructor, releasing the branch addresses and re-enabling all branches
+     */
+    ~ValidationReader();
+
+    /**
+     *  @brief  Read an event from the chain
+     *
+     *  @param  firstEntry the first chain entry of the event
+     *  @param  endEntry the chain entry after the last entry of the event
+     *  @param  simpleMCEvent the event to be populated
+     */
+    void ReadEvent(const int firstEntry, const int endEntry, SimpleMCEvent &simpleMCEvent);
+
+private:
+    /**
+     *  @brief  Enable a branch, bind it to an address and add it to the tree cache
+     *
+     *  @param  branchName the branch name
+     *  @param  pAddress the address to receive the branch value
+     */
+    template <typename T>
+    void BindBranch(const std::string &branchName, T *const pAddress);
+
+    /**
+     *  @brief  Append the values of a vector branch for the primaries of the current entry to a column, or default values if the branch
+     *          is not read
+     *
+     *  @param  pValues the address of the branch values, nullptr if the branch is not read
+     *  @param  nPrimaries the number of primaries of the current entry
+     *  @param  defaultValue the value for each primary if the branch is not read
+     *  @param  column the column to receive the values
+     */
+    template <typename T>
+    static void AppendColumn(const std::vector<T> *const pValues, const int nPrimaries, const T defaultValue, std::vector<T> &column);
+
+    static const Long64_t   READ_CACHE_SIZE = 100 * 1024 * 1024;    ///< The size of the tree cache, in bytes
+
+    TChain *const           m_pTChain;                  ///< The address of the chain
+    const bool              m_testBeamMode;             ///< Whether to read the test beam, rather than neutrino, branches
+    const bool              m_readMomenta;              ///< Whether to read the primary momenta, needed only for histograms
+    const bool              m_readDisplayDetails;       ///< Whether to read the details needed only to display matched events
+
+    int                     m_eventNumber;              ///< The event number of the current entry
+    int                     m_fileIdentifier;           ///< The file identifier of the current entry
+    SimpleMCTarget          m_mcTarget;                 ///< The target details of the current entry, without its mc primaries
+
+    IntVector              *m_pMCPrimaryId;                     ///< The mc primary identifiers
+    IntVector              *m_pMCPrimaryPdg;                    ///< The mc primary pdg codes
+    IntVector              *m_pNMCHitsTotal;                    ///< The mc primary total numbers of hits
+    IntVector              *m_pNMCHitsU;                        ///< The mc primary numbers of u hits
+    IntVector              *m_pNMCHitsV;                        ///< The mc primary numbers of v hits
+    IntVector              *m_pNMCHitsW;                        ///< The mc primary numbers of w hits
+    FloatVector            *m_pMCPrimaryE;                      ///< The mc primary energies
+    FloatVector            *m_pMCPrimaryPX;                     ///< The mc primary momentum x components
+    FloatVector            *m_pMCPrimaryPY;                     ///< The mc primary momentum y components
+    FloatVector            *m_pMCPrimaryPZ;                     ///< The mc primary momentum z components
+    FloatVector            *m_pMCPrimaryVtxX;                   ///< The mc primary vertex x coordinates
+    FloatVector            *m_pMCPrimaryVtxY;                   ///< The mc primary vertex y coordinates
+    FloatVector            *m_pMCPrimaryVtxZ;                   ///< The mc primary vertex z coordinates
+    FloatVector            *m_pMCPrimaryEndX;                   ///< The mc primary endpoint x coordinates
+    FloatVector            *m_pMCPrimaryEndY;                   ///< The mc primary endpoint y coordinates
+    FloatVector            *m_pMCPrimaryEndZ;                   ///< The mc primary endpoint z coordinates
+    IntVector              *m_pNPrimaryMatchedPfos;             ///< The numbers of matched pfos
+    IntVector              *m_pNPrimaryMatchedNuPfos;           ///< The numbers of matched nu pfos
+    IntVector              *m_pNPrimaryMatchedCRPfos;           ///< The numbers of matched cr pfos
+    IntVector              *m_pBestMatchPfoId;                  ///< The best match pfo identifiers
+    IntVector              *m_pBestMatchPfoPdg;                 ///< The best match pfo pdg codes
+    IntVector              *m_pBestMatchPfoIsRecoNu;            ///< Whether each best match pfo is part of a neutrino hierarchy
+    IntVector              *m_pBestMatchPfoRecoNuId;            ///< The identifiers of the associated reco neutrinos
+    IntVector              *m_pBestMatchPfoIsTestBeam;          ///< Whether each best match pfo is a test beam particle
+    IntVector              *m_pBestMatchPfoNHitsTotal;          ///< The best match pfo total numbers of hits
+    IntVector              *m_pBestMatchPfoNHitsU;              ///< The best match pfo numbers of u hits
+    IntVector              *m_pBestMatchPfoNHitsV;              ///< The best match pfo numbers of v hits
+    IntVector              *m_pBestMatchPfoNHitsW;              ///< The best match pfo numbers of w hits
+    IntVector              *m_pBestMatchPfoNSharedHitsTotal;    ///< The best match pfo total numbers of matched hits
+    IntVector              *m_pBestMatchPfoNSharedHitsU;        ///< The best match pfo numbers of u matched hits
+    IntVector              *m_pBestMatchPfoNSharedHitsV;        ///< The best match pfo numbers of v matched hits
+    IntVector              *m_pBestMatchPfoNSharedHitsW;        ///< The best match pfo numbers of w matched hits
+};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -539,126 +1054,184 @@ typedef std::map<InteractionType, PrimaryHistogramMap> InteractionPrimaryHistogr
 void Validation(const std::string &inputFiles, const Parameters &parameters = Parameters());
 
 /**
- *  @brief  Read the next event from the chain
+ *  @brief  Validation, dividing the events between threads, each processing its own range of events. The per-range results are merged
+ *          in chain order, so the output is that of a single-threaded pass over the chain.
+ *
+ *  @param  inputFiles the regex identifying the input root files
+ *  @param  parameters the parameters
+ */
+void ValidateConcurrently(const std::string &inputFiles, const Parameters &parameters);
+
+/**
+ *  @brief  Display the matching details of a single event, found directly through the event index
+ *
+ *  @param  inputFiles the regex identifying the input root files
+ *  @param  iEvent the position of the event in the chain
+ *  @param  parameters the parameters
+ */
+void DisplayEvent(const std::string &inputFiles, const int iEvent, const Parameters &parameters = Parameters());
+
+/**
+ *  @brief  Fill the event index for a chain, reading it from the event index file if that matches the chain, else writing it there
  *
  *  @param  pTChain the address of the chain
- *  @param  iEntry the first chain entry to read
- *  @param  simpleMCEvent the event to be populated
  *  @param  parameters the parameters
+ *  @param  eventIndex the event index, to be filled
+ */
+void FillEventIndex(TChain *const pTChain, const Parameters &parameters, EventIndex &eventIndex);
+
+/**
+ *  @brief  Get the range of events to be processed, after skipping events and limiting the number to be processed
+ *
+ *  @param  eventIndex the event index
+ *  @param  parameters the parameters
+ *  @param  firstEvent to receive the position of the first event to be processed
+ *  @param  lastEvent to receive the position after that of the last event to be processed
+ */
+void GetEventRange(const EventIndex &eventIndex, const Parameters &parameters, int &firstEvent, int &lastEvent);
+
+/**
+ *  @brief  Run a function for each of a number of ranges, each in its own thread, rethrowing the first exception from any thread
+ *
+ *  @param  nRanges the number of ranges
+ *  @param  exceptionList to receive any exception thrown for each range
+ *  @param  function the function, receiving the range index
+ */
+void RunConcurrently(const unsigned int nRanges, std::vector<std::exception_ptr> &exceptionList, const std::function<void(const unsigned int)> &function);
+
+/**
+ *  @brief  Merge an interaction counting table into another, summing the counting details for each interaction type and expected primary
  *
- *  @return the number of chain entries read
+ *  @param  inputTable the interaction counting table to be merged
+ *  @param  outputTable the interaction counting table to receive the merged counts
  */
-int ReadNextEvent(TChain *const pTChain, const int iEntry, SimpleMCEvent &simpleMCEvent, const Parameters &parameters);
+void MergeInteractionCountingTable(const InteractionCountingTable &inputTable, InteractionCountingTable &outputTable);
 
 /**
- *  @brief  Print matching details to screen for a simple mc event
+ *  @brief  Merge an interaction target result table into another, appending the target results for each interaction type
+ *
+ *  @param  inputTable the interaction target result table to be merged
+ *  @param  outputTable the interaction target result table to receive the merged target results
+ */
+void MergeInteractionTargetResultTable(const InteractionTargetResultTable &inputTable, InteractionTargetResultTable &outputTable);
+
+/**
+ *  @brief  Print matching details for a simple mc event
  *
  *  @param  simpleMCEvent the simple mc event
  *  @param  parameters the parameters
+ *  @param  outputStream the stream to receive the matching details
  */
-void DisplaySimpleMCEventMatches(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters);
+void DisplaySimpleMCEventMatches(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, std::ostream &outputStream = std::cout);
 
 /**
  *  @brief  CountPfoMatches Relies on fact that primary list is sorted by number of true good hits
  *
  *  @param  simpleMCEvent the simple mc event
  *  @param  parameters the parameters
- *  @param  interactionCountingMap the interaction counting map, to be populated
- *  @param  interactionTargetResultMap the interaction target outcome map, to be populated
+ *  @param  interactionCountingTable the interaction counting table, to be populated
+ *  @param  interactionTargetResultTable the interaction target outcome table, to be populated
  */
-void CountPfoMatches(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, InteractionCountingMap &interactionCountingMap,
-    InteractionTargetResultMap &interactionTargetResultMap);
+void CountPfoMatches(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, InteractionCountingTable &interactionCountingTable,
+    InteractionTargetResultTable &interactionTargetResultTable);
 
 /**
- *  @brief  Whether a simple mc event passes the relevant fiducial cut, applied to target vertices
+ *  @brief  Whether each target passes the relevant fiducial cut, applied to target vertices
  *
- *  @param  simpleMCTarget the simple mc target
+ *  @param  simpleMCTargets the simple mc targets
  *  @param  parameters the parameters
- *
- *  @return boolean
+ *  @param  passFiducialCutList to receive whether each target passes the cut
  */
-bool PassFiducialCut(const SimpleMCTarget &simpleMCTarget, const Parameters &parameters);
+void PassFiducialCut(const SimpleMCTargetColumns &simpleMCTargets, const Parameters &parameters, IntVector &passFiducialCutList);
 
 /**
- *  @brief  Whether a simple mc event passes uboone fiducial cut, applied to target vertices
+ *  @brief  Whether each target passes uboone fiducial cut, applied to target vertices
  *
- *  @param  simpleMCTarget the simple mc target
- *
- *  @return boolean
+ *  @param  simpleMCTargets the simple mc targets
+ *  @param  passFiducialCutList to receive whether each target passes the cut
  */
-bool PassUbooneFiducialCut(const SimpleMCTarget &simpleMCTarget);
+void PassUbooneFiducialCut(const SimpleMCTargetColumns &simpleMCTargets, IntVector &passFiducialCutList);
 
 /**
- *  @brief  Whether a simple mc event passes sbnd fiducial cut, applied to target vertices
+ *  @brief  Whether each target passes sbnd fiducial cut, applied to target vertices
  *
- *  @param  simpleMCTarget the simple mc target
+ *  @param  simpleMCTargets the simple mc targets
+ *  @param  passFiducialCutList to receive whether each target passes the cut
+ */
+void PassSBNDFiducialCut(const SimpleMCTargetColumns &simpleMCTargets, IntVector &passFiducialCutList);
+
+/**
+ *  @brief  Calculate the best match completeness and purity, and the true momentum, of each mc primary
  *
- *  @return boolean
+ *  @param  simpleMCPrimaries the simple mc primaries
+ *  @param  completenessList to receive the completeness of each best matched pfo
+ *  @param  purityList to receive the purity of each best matched pfo
+ *  @param  trueMomentumList to receive the true momentum of each mc primary
  */
-bool PassSBNDFiducialCut(const SimpleMCTarget &simpleMCTarget);
+void CalculatePrimaryMatchQuality(const SimpleMCPrimaryColumns &simpleMCPrimaries, FloatVector &completenessList, FloatVector &purityList,
+    FloatVector &trueMomentumList);
 
 /**
- *  @brief  Work out which of the primary particles (expected for a given interaction types) corresponds to the provided primary id
+ *  @brief  Work out which of the primary particles (expected for a given interaction types) corresponds to each mc primary of each target
  *          ATTN: Relies on fact that primary list is sorted by number of true hits
  *
- *  @param  simpleMCPrimary the simple mc primary
- *  @param  simpleMCPrimaryList the simple mc primary list
- *
- *  @return the expected primary
+ *  @param  simpleMCEvent the simple mc event
+ *  @param  expectedPrimaryList to receive the expected primary of each mc primary
  */
-ExpectedPrimary GetExpectedPrimary(const SimpleMCPrimary &simpleMCPrimary, const SimpleMCPrimaryList &simpleMCPrimaryList);
+void GetExpectedPrimaries(const SimpleMCEvent &simpleMCEvent, ExpectedPrimaryList &expectedPrimaryList);
 
 /**
  *  @brief  Whether a provided mc primary and best matched pfo are deemed to have a good particle id match
  *
- *  @param  simpleMCPrimary the simple mc primary
+ *  @param  mcPdgCode the mc primary pdg code
  *  @param  bestMatchPfoPdgCode the best matched pfo pdg code
  *
  *  @return boolean
  */
-bool IsGoodParticleIdMatch(const SimpleMCPrimary &simpleMCPrimary, const int bestMatchPfoPdgCode);
+bool IsGoodParticleIdMatch(const int mcPdgCode, const int bestMatchPfoPdgCode);
 
 /**
- *  @brief  Print details to screen for a provided interaction type to counting map
+ *  @brief  Print details to screen for a provided interaction type to counting table
  *
- *  @param  interactionCountingMap the interaction counting map
+ *  @param  interactionCountingTable the interaction counting table
  *  @param  parameters the parameters
  */
-void DisplayInteractionCountingMap(const InteractionCountingMap &interactionCountingMap, const Parameters &parameters);
+void DisplayInteractionCountingTable(const InteractionCountingTable &interactionCountingTable, const Parameters &parameters);
 
 /**
  *  @brief  Opportunity to fill histograms, perform post-processing of information collected in main loop over ntuple, etc.
  *
- *  @param  interactionTargetResultMap the interaction target result map
+ *  @param  interactionTargetResultTable the interaction target result table
  *  @param  parameters the parameters
  */
-void AnalyseInteractionTargetResultMap(const InteractionTargetResultMap &interactionTargetResultMap, const Parameters &parameters);
+void AnalyseInteractionTargetResultTable(const InteractionTargetResultTable &interactionTargetResultTable, const Parameters &parameters);
 
 /**
- *  @brief  Fill histograms in the provided target histogram collection, using information in the provided target result
+ *  @brief  Fill histograms in the provided (booked) target histogram collection, using information in the provided target result
  *
- *  @param  histPrefix the histogram prefix
- *  @param  targetResult the target result
+ *  @param  targetResults the target results
+ *  @param  iTarget the position of the target result
  *  @param  targetHistogramCollection the target histogram collection
  */
-void FillTargetHistogramCollection(const std::string &histPrefix, const TargetResult &targetResult, TargetHistogramCollection &targetHistogramCollection);
+void FillTargetHistogramCollection(const TargetResultColumns &targetResults, const int iTarget, TargetHistogramCollection &targetHistogramCollection);
 
 /**
- *  @brief  Fill histograms in the provided histogram collection, using information in the provided primary result
+ *  @brief  Fill histograms in the provided (booked) histogram collection, using information in the provided primary result
  *
- *  @param  histPrefix the histogram prefix
  *  @param  parameters the parameters
- *  @param  primaryResult the primary result
+ *  @param  targetResults the target results
+ *  @param  iPrimary the position of the primary result
  *  @param  primaryHistogramCollection the primary histogram collection
  */
-void FillPrimaryHistogramCollection(const std::string &histPrefix, const Parameters &parameters, const PrimaryResult &primaryResult, PrimaryHistogramCollection &primaryHistogramCollection);
+void FillPrimaryHistogramCollection(const Parameters &parameters, const TargetResultColumns &targetResults, const int iPrimary,
+    PrimaryHistogramCollection &primaryHistogramCollection);
 
 /**
- *  @brief  Process histograms stored in the provided map e.g. calculating final efficiencies, normalising, etc.
+ *  @brief  Process histograms stored in the provided registry e.g. calculating final efficiencies, normalising, etc.
  *
- *  @param  interactionPrimaryHistogramMap the interaction primary histogram map
+ *  @param  histogramRegistry the histogram registry
  */
-void ProcessHistogramCollections(const InteractionPrimaryHistogramMap &interactionPrimaryHistogramMap);
+void ProcessHistogramCollections(const HistogramRegistry &histogramRegistry);
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -667,6 +1240,8 @@ Parameters::Parameters() :
     m_displayMatchedEvents(true),
     m_skipEvents(0),
     m_nEventsToProcess(std::numeric_limits<int>::max()),
+    m_nThreads(1),
+    m_eventIndexFileName(""),
     m_applyUbooneFiducialCut(false),
     m_applySBNDFiducialCut(false),
     m_correctTrackShowerId(false),
@@ -713,34 +1288,9 @@ SimpleThreeVector operator+(const SimpleThreeVector &lhs, const SimpleThreeVecto
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-SimpleMCPrimary::SimpleMCPrimary() :
-    m_primaryId(-1),
-    m_pdgCode(0),
-    m_energy(0.f),
-    m_momentum(0.f, 0.f, 0.f),
-    m_vertex(-1.f, -1.f, -1.f),
-    m_endpoint(-1.f, -1.f, -1.f),
-    m_nMCHitsTotal(0),
-    m_nMCHitsU(0),
-    m_nMCHitsV(0),
-    m_nMCHitsW(0),
-    m_nPrimaryMatchedPfos(0),
-    m_nPrimaryMatchedNuPfos(0),
-    m_nPrimaryMatchedCRPfos(0),
-    m_bestMatchPfoId(-1),
-    m_bestMatchPfoPdgCode(0),
-    m_bestMatchPfoIsRecoNu(0),
-    m_bestMatchPfoRecoNuId(-1),
-    m_bestMatchPfoIsTestBeam(0),
-    m_bestMatchPfoNHitsTotal(0),
-    m_bestMatchPfoNHitsU(0),
-    m_bestMatchPfoNHitsV(0),
-    m_bestMatchPfoNHitsW(0),
-    m_bestMatchPfoNSharedHitsTotal(0),
-    m_bestMatchPfoNSharedHitsU(0),
-    m_bestMatchPfoNSharedHitsV(0),
-    m_bestMatchPfoNSharedHitsW(0)
+int SimpleMCPrimaryColumns::GetNPrimaries() const
 {
+    return m_pdgCodeList.size();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -775,10 +1325,38 @@ SimpleMCTarget::SimpleMCTarget() :
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+SimpleMCTargetColumns::SimpleMCTargetColumns() :
+    m_firstPrimaryList(1, 0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int SimpleMCTargetColumns::GetNTargets() const
+{
+    return m_interactionTypeList.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int SimpleMCTargetColumns::GetFirstPrimary(const int iTarget) const
+{
+    return m_firstPrimaryList[iTarget];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int SimpleMCTargetColumns::GetEndPrimary(const int iTarget) const
+{
+    return m_firstPrimaryList[iTarget + 1];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 SimpleMCEvent::SimpleMCEvent() :
     m_fileIdentifier(-1),
-    m_eventNumber(0),
-    m_nMCTargets(0)
+    m_eventNumber(0)
 {
 }
 
@@ -798,6 +1376,28 @@ CountingDetails::CountingDetails() :
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+InteractionCountingTable::InteractionCountingTable() :
+    m_countingDetailsList(N_INTERACTION_TYPES * N_EXPECTED_PRIMARIES)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+CountingDetails &InteractionCountingTable::GetCountingDetails(const InteractionType interactionType, const ExpectedPrimary expectedPrimary)
+{
+    return m_countingDetailsList[interactionType * N_EXPECTED_PRIMARIES + expectedPrimary];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const CountingDetails &InteractionCountingTable::GetCountingDetails(const InteractionType interactionType, const ExpectedPrimary expectedPrimary) const
+{
+    return m_countingDetailsList[interactionType * N_EXPECTED_PRIMARIES + expectedPrimary];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 PrimaryResult::PrimaryResult() :
     m_nPfoMatches(0),
     m_nMCHitsTotal(0),
@@ -813,15 +1413,54 @@ PrimaryResult::PrimaryResult() :
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-TargetResult::TargetResult() :
-    m_fileIdentifier(-1),
-    m_eventNumber(-1),
-    m_isCorrect(false),
-    m_hasRecoVertex(false),
-    m_vertexOffset(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max())
+TargetResultColumns::TargetResultColumns() :
+    m_firstPrimaryList(1, 0)
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int TargetResultColumns::GetNTargets() const
+{
+    return m_isCorrectList.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int TargetResultColumns::GetFirstPrimary(const int iTarget) const
+{
+    return m_firstPrimaryList[iTarget];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int TargetResultColumns::GetEndPrimary(const int iTarget) const
+{
+    return m_firstPrimaryList[iTarget + 1];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+InteractionTargetResultTable::InteractionTargetResultTable() :
+    m_targetResultsList(N_INTERACTION_TYPES)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TargetResultColumns &InteractionTargetResultTable::GetTargetResults(const InteractionType interactionType)
+{
+    return m_targetResultsList[interactionType];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const TargetResultColumns &InteractionTargetResultTable::GetTargetResults(const InteractionType interactionType) const
+{
+    return m_targetResultsList[interactionType];
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -846,4 +1485,48 @@ TargetHistogramCollection::TargetHistogramCollection() :
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const PrimaryHistogramCollectionList &HistogramRegistry::GetPrimaryHistogramCollectionList() const
+{
+    return m_primaryHistogramCollectionList;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventIndex::EventIndex() :
+    m_firstEntryList(1, 0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int EventIndex::GetNEvents() const
+{
+    return m_eventNumberList.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int EventIndex::GetFirstEntry(const int iEvent) const
+{
+    return m_firstEntryList.at(iEvent);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int EventIndex::GetEndEntry(const int iEvent) const
+{
+    return m_firstEntryList.at(iEvent + 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int EventIndex::GetEventNumber(const int iEvent) const
+{
+    return m_eventNumberList.at(iEvent);
+}
+
 #endif // #ifndef NEW_LAR_VALIDATION_H